@@ -0,0 +1,39 @@
+//
+// Approximate RW labeling: capped fan-in cones and a time budget, with proven bounds on the max IO delay
+//
+
+#ifndef RW_APPROXIMATE_H
+#define RW_APPROXIMATE_H
+
+#include <vector>
+#include "Node.h"
+#include "Labeling.h"
+
+//Every node v is labeled from at most coneLimit candidates: the ancestors of v with the highest topological
+//positions. Every path from such a candidate to v stays inside the candidates, so their delays to v are
+//exact and need no delay matrix. The ancestors left out can only be outside cluster(v); together they are
+//accounted for by the candidates' boundary (the left-out fan-ins of v and of the candidates), each charged
+//with the worst arrival of anything behind it.
+//
+//Two labels are kept per node:
+//  upper: the RW label of a cluster built from the candidates, with every left-out ancestor charged the
+//         intercluster delay. These are the labels and clusters of the result, so computeClusters and the
+//         output files work as usual, and max(upper) is an upper bound on the exact RW max IO delay.
+//  lower: the K-th best label_v among the candidates and the boundary (K = max cluster size) plus the
+//         intercluster delay, and the longest PI path to v. max(lower) is a lower bound on it.
+//Labeling a node whose cone fits in coneLimit gives the exact RW label and cluster; with a large enough
+//limit and no budget the result equals computeLabels. Once budgetMs of labeling has passed, the remaining
+//nodes get no candidates at all (cluster(v) = {v}), which takes time linear in their fan-in.
+//Both bounds assume delays of 0 or more.
+struct ApproxStats {
+    int lowerBound = 0;        //max IO delay bounds, valid when the run was not interrupted
+    int upperBound = 0;
+    size_t cutCones = 0;       //nodes whose cone was larger than the candidates they were labeled from
+    size_t budgetNodes = 0;    //nodes labeled without candidates after the time budget ran out
+};
+
+//RW only, after initializeLabels (with no restored prefix); coneLimit <= 0 means no limit, budgetMs <= 0 no budget
+void computeLabelsApproximate(std::vector<Node*>& master, LabelingOptions& opts, LabelingResult& res,
+                              int coneLimit, long long budgetMs, ApproxStats& stats);
+
+#endif //RW_APPROXIMATE_H
@@ -0,0 +1,42 @@
+//
+// Batch mode: cluster many BLIF netlists in one process on a worker pool
+//
+
+#ifndef RW_BATCH_H
+#define RW_BATCH_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+//Statistics of one circuit, as printed at the end of a normal run
+struct CircuitStats {
+    std::string circuitName;
+    bool ok = false;
+    int nodes = 0;
+    int clusters = 0;
+    int maxIODelay = 0;
+    long int clusterAreaCost = 0;
+    long long parseUs = 0;
+    long long topoUs = 0;
+    long long delayMatrixUs = 0;
+    long long labelUs = 0;
+    long long clusterUs = 0;
+    long long totalUs = 0;
+    std::string error;   //why the netlist could not be read, for the batch report
+};
+
+struct BatchJob {
+    std::string file;
+    long long fileBytes = 0;
+    CircuitStats stats;
+};
+
+//circuit names are unique within the batch (see makeNamesUnique), so no two jobs share output files
+std::vector<BatchJob> collectBatchFiles(std::string path);
+int batchWorkerCount(int requested, std::vector<BatchJob>& batch);
+void runBatch(std::vector<BatchJob>& batch, int jobs, std::function<void(BatchJob&)> runOne);
+void writeBatchReport(std::string filename, std::vector<BatchJob>& batch);
+void printBatchReport(std::vector<BatchJob>& batch, long long wallUs);
+
+#endif //RW_BATCH_H
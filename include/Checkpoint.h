@@ -0,0 +1,46 @@
+//
+// Checkpoint and resume of the labeling phase (--checkpoint / --resume)
+//
+
+#ifndef RW_CHECKPOINT_H
+#define RW_CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Node.h"
+#include "Labeling.h"
+
+//Labeling state of an interrupted run; node ids are positions in the recorded topological order
+struct CheckpointState {
+    int maxClusterSize;
+    int interClusterDelay;
+    int piDelay;
+    int poDelay;
+    int nodeDelay;
+    int useLawler;
+    uint64_t nameHash;                       //names of the nodes in topological order
+    std::vector<uint32_t> order;             //topological order as indices into the parsed node list
+    uint64_t labeledNodes;
+    int maxLabel;
+    int maxIODelay;
+    std::vector<int> labels;                 //indexed by node id
+    std::vector<std::vector<uint32_t>> members;  //RW: cluster(v) members of the labeled nodes
+};
+
+//the labeling file is rewritten in place (through a temporary file, so a kill never leaves half of one);
+//the delay matrix goes to <filename>.delays once, right after it is built
+bool writeCheckpoint(std::string filename, std::vector<Node>& rawNodeList, std::vector<Node*>& master,
+                     LabelingResult& res, LabelingOptions& opts, int piDelay, int poDelay, int nodeDelay);
+bool loadCheckpoint(std::string filename, CheckpointState& state);
+bool writeDelayCheckpoint(std::string filename, DelayData& dd);
+bool loadDelayCheckpoint(std::string filename, int N, DelayData& dd);
+//deletes <filename> and <filename>.delays after a run whose labeling completed
+void removeCheckpoint(std::string filename);
+
+//rebuilds master in the recorded order (and numbers it); false if the netlist is not the checkpointed one
+bool restoreCheckpointOrder(CheckpointState& state, std::vector<Node>& rawNodeList, std::vector<Node*>& master);
+//after initializeLabels: restores the labels and clusters of the nodes labeled before the checkpoint
+void restoreCheckpointLabels(CheckpointState& state, std::vector<Node*>& master, LabelingResult& res);
+
+#endif //RW_CHECKPOINT_H
@@ -18,6 +18,7 @@ struct Cluster {
     int calcL1Value();
     Cluster(int);
     std::vector<Node *> inputSet;
+    bool tieFree = false; //RW labeling saw no equal label_v among the best candidates, so the node order did not matter
     bool static isClusterInList(int cID,std::vector<Cluster*>& cList);
     bool static isClusterInList_str(std::string sID,std::vector<Cluster*>& cList);
     //TODO: need lists of input/output Nodes? Clusters?
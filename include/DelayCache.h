@@ -0,0 +1,40 @@
+//
+// Persistent delay matrix cache (--delay_cache): built once per netlist, memory mapped by later runs
+//
+
+#ifndef RW_DELAYCACHE_H
+#define RW_DELAYCACHE_H
+
+#include <string>
+#include <cstdint>
+#include <vector>
+#include "Node.h"
+#include "Labeling.h"
+
+#define DELAY_CACHE_MISSING 0   //no cache file yet
+#define DELAY_CACHE_LOADED 1
+#define DELAY_CACHE_STALE 2     //a cache of another netlist, delays, matrix type or order: rebuild it
+#define DELAY_CACHE_INVALID 3   //truncated or not a cache file: rebuild it
+
+//Everything a delay matrix depends on. Cluster size, inter-cluster delay and --exp only matter to labeling,
+//so runs that differ in those share one cache file.
+struct DelayCacheKey {
+    uint64_t netlistHash;   //FNV-1a of the BLIF file contents
+    uint64_t orderHash;     //names and delays of the nodes in topological order (node ids index the matrix)
+    int32_t piDelay;
+    int32_t poDelay;
+    int32_t nodeDelay;
+    int32_t mode;           //DELAY_DENSE or DELAY_SPARSE
+    int32_t N;
+};
+
+//false if the BLIF file cannot be read
+bool makeDelayCacheKey(std::string blifFile, std::vector<Node*>& master, int N, int piDelay, int poDelay,
+                       int nodeDelay, int mode, DelayCacheKey& key);
+//maps filename read-only into dd when its key equals key (the pages are shared with the page cache and
+//read on first use); reason says why a file that exists was not used
+int loadDelayCache(std::string filename, const DelayCacheKey& key, DelayData& dd, std::string& reason);
+//written through a temporary file, so concurrent runs never see half of one
+bool writeDelayCache(std::string filename, const DelayCacheKey& key, DelayData& dd);
+
+#endif //RW_DELAYCACHE_H
@@ -0,0 +1,99 @@
+//
+// Delay provider policies: compile-time selected sources of d(x, v) for the RW labeling loop
+//
+
+#ifndef RW_DELAYPROVIDER_H
+#define RW_DELAYPROVIDER_H
+
+#include <vector>
+#include <cstdint>
+#include "Node.h"
+#include "Labeling.h"
+
+//Every provider offers prepare(v, S, scratch), called once per labeled node while the cone S is still
+//marked in scratch.visited, and get(x, v, scratch) = longest path delay from x to v.
+//UNIT providers assume every node with fan-in has delay 1 (DelayData::unitDelay).
+//topologicalCone: prepare() needs S in topological order, so the cone is never collected in parallel.
+
+template <typename T>
+struct DenseDelayProvider {
+    static const bool topologicalCone = false;
+    const T *matrix;
+    long long N;
+    explicit DenseDelayProvider(const DelayData& dd) : matrix((const T*) dd.dense), N(dd.N) {}
+    void prepare(Node*, std::vector<Node*>&, LabelScratch&) {}
+    int get(const Node* x, const Node* v, const LabelScratch&) const {
+        return matrix[N * x->id + v->id];
+    }
+};
+
+struct SparseDelayProvider {
+    static const bool topologicalCone = false;
+    SparseMatrix *matrix;
+    explicit SparseDelayProvider(const DelayData& dd) : matrix(dd.sparse) {}
+    void prepare(Node*, std::vector<Node*>&, LabelScratch&) {}
+    int get(const Node* x, const Node* v, const LabelScratch&) const {
+        return matrix->get(x->id, v->id);
+    }
+};
+
+template <bool UNIT>
+int maxDelayT(const Node* src, const Node* dst, const std::vector<Node*>& nodes);
+
+template <bool UNIT>
+struct OnTheFlyDelayProvider {
+    static const bool topologicalCone = false;
+    const std::vector<Node*> *master;
+    explicit OnTheFlyDelayProvider(const std::vector<Node*>& m) : master(&m) {}
+    void prepare(Node*, std::vector<Node*>&, LabelScratch&) {}
+    int get(const Node* x, const Node* v, const LabelScratch&) const {
+        return maxDelayT<UNIT>(x, v, *master);
+    }
+};
+
+template <bool UNIT>
+struct ConeDelayProvider {
+    static const bool topologicalCone = true;
+    void prepare(Node* v, std::vector<Node*>& S, LabelScratch& scratch);
+    int get(const Node* x, const Node*, const LabelScratch& scratch) const {
+        return scratch.coneDelay[x->id];
+    }
+};
+
+//unit delays: d(x, v) is the longest path length from x to v within v's cone, pushed backwards from v
+//along fan-in edges into a T sized array
+template <typename T>
+struct UnitDelayProvider {
+    static const bool topologicalCone = true;
+    void prepare(Node* v, std::vector<Node*>& S, LabelScratch& scratch);
+    int get(const Node* x, const Node*, const LabelScratch& scratch) const;
+};
+
+//calls op(provider) with the provider matching dd (mode, entry width, unit delay)
+template <class Op>
+void dispatchDelayProvider(DelayData& dd, const std::vector<Node*>& master, Op& op){
+    if (dd.mode == DELAY_DENSE){
+        if (dd.width == 1) { DenseDelayProvider<uint8_t> p(dd); op(p); }
+        else if (dd.width == 2) { DenseDelayProvider<uint16_t> p(dd); op(p); }
+        else { DenseDelayProvider<int> p(dd); op(p); }
+    }
+    else if (dd.mode == DELAY_SPARSE){
+        SparseDelayProvider p(dd);
+        op(p);
+    }
+    else if (dd.mode == DELAY_UNIT){
+        if (dd.width == 1) { UnitDelayProvider<uint8_t> p; op(p); }
+        else if (dd.width == 2) { UnitDelayProvider<uint16_t> p; op(p); }
+        else { UnitDelayProvider<int> p; op(p); }
+    }
+    else if (dd.mode == DELAY_CONE){
+        if (dd.unitDelay) { ConeDelayProvider<true> p; op(p); }
+        else { ConeDelayProvider<false> p; op(p); }
+    }
+    else {
+        if (dd.unitDelay) { OnTheFlyDelayProvider<true> p(master); op(p); }
+        else { OnTheFlyDelayProvider<false> p(master); op(p); }
+    }
+}
+
+#endif //RW_DELAYPROVIDER_H
@@ -0,0 +1,60 @@
+//
+// ECO mode: incremental re-labeling after small netlist edits
+//
+
+#ifndef RW_ECO_H
+#define RW_ECO_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Node.h"
+#include "Labeling.h"
+
+//One node of a saved run, in the topological order of that run
+struct EcoNode {
+    std::string name;
+    int delay;
+    bool isPI;
+    bool isPO;
+    bool tieFree;                   //Cluster::tieFree of the saved run
+    int label;
+    std::vector<uint32_t> fanins;   //indices into EcoState::nodes
+    std::vector<uint32_t> members;  //cluster(v) members, indices into EcoState::nodes
+    std::vector<uint32_t> inputs;   //input set of cluster(v), indices into EcoState::nodes
+};
+
+//Labels and clusters of a previous RW run plus everything needed to tell what changed
+struct EcoState {
+    int maxClusterSize;
+    int interClusterDelay;
+    int piDelay;
+    int poDelay;
+    int nodeDelay;
+    std::vector<EcoNode> nodes;
+    std::vector<uint32_t> poOrder;  //POs in netlist order (drives the clustering phase)
+    std::vector<int32_t> match;     //saved node of every rawNodeList entry of the new netlist, -1 for added nodes
+};
+
+struct EcoStats {
+    int changed = 0;   //nodes added or whose delay, PI role or fan-ins differ from the saved run
+    int dirty = 0;     //nodes relabeled: changed nodes, their transitive fan-out and the reordered ones
+    int reordered = 0; //relabeled only because the new topological order may break label_v ties differently
+    int reused = 0;    //labels and clusters taken from the saved run
+};
+
+bool saveEcoState(std::string filename, std::vector<Node*>& master, std::vector<Node*>& POs,
+                  LabelingResult& res, LabelingOptions& opts, int piDelay, int poDelay, int nodeDelay);
+bool loadEcoState(std::string filename, EcoState& state);
+//fills state.match itself; for a complete new BLIF, matchEcoNodes finds the saved nodes by name.
+//Returns false with error set (nothing is printed) if the diff cannot be applied
+bool buildNetlistFromDiff(EcoState& state, std::string diffFile, int& piDelay, int& poDelay, int& nodeDelay,
+                          std::vector<Node>& rawNodeList, std::vector<Node*>& POs, std::string& error);
+void matchEcoNodes(EcoState& state, std::vector<Node>& rawNodeList);
+//The result equals computeLabels on the new netlist: a node keeps its saved label and cluster only if
+//its fan-in cone, the labels in it and the relative order of its nodes (which breaks label_v ties) are
+//the same as in the saved run. Nodes that are not relabeled cost O(fan-in + cluster size).
+void computeLabelsIncremental(std::vector<Node*>& master, std::vector<Node>& rawNodeList, EcoState& state,
+                              LabelingOptions& opts, LabelingResult& res, EcoStats& stats);
+
+#endif //RW_ECO_H
@@ -0,0 +1,50 @@
+//
+// Level-of-detail GUI export: views of a binary result file (.rwb) small enough for the Python GUI
+//
+
+#ifndef RW_GUIEXPORT_H
+#define RW_GUIEXPORT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ResultFile.h"
+
+#define GUI_VIEW_NODES 0     //one vertex per netlist node
+#define GUI_VIEW_CLUSTERS 1  //one vertex per final cluster, edges from the cluster input sets
+#define GUI_VIEW_LEVELS 2    //one vertex per logic level (longest path from a source, in nodes)
+
+//One vertex of a view; prev and cluster hold vertex indices of the same view
+struct GuiVertex {
+    std::string name;
+    int delay;
+    int label;
+    std::vector<uint32_t> prev;
+    std::vector<uint32_t> next;
+    std::vector<uint32_t> cluster;
+};
+
+struct GuiCluster {
+    uint32_t root;
+    bool initial;   //part of the first L set (a primary output or a sink of the view)
+    std::vector<uint32_t> members;
+    std::vector<uint32_t> inputs;
+};
+
+//A subgraph of a result file at one granularity, written in the Python/input_graph.dmp format
+struct GuiView {
+    int granularity;
+    std::vector<GuiVertex> vertices;
+    std::vector<GuiCluster> clusters;
+    int maxIODelay;
+};
+
+//Picks the vertices of the view: the fan-in neighbourhood (up to depth edges, -1 = whole cone) of the
+//vertices that hold the named nodes, or every vertex if no names are given. Only the selected part of
+//the mapped file is read, apart from per-node index arrays for the cluster and level granularities.
+bool selectGuiVertices(const ResultFileReader& rf, int granularity, const std::vector<std::string>& seeds,
+                       int depth, std::vector<uint32_t>& selected, std::string& error);
+void buildGuiView(const ResultFileReader& rf, int granularity, const std::vector<uint32_t>& selected, GuiView& view);
+bool writeGuiView(const GuiView& view, std::string filename);
+
+#endif //RW_GUIEXPORT_H
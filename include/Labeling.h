@@ -0,0 +1,121 @@
+//
+// Labeling and clustering phases of the RW/Lawler clustering application
+//
+
+#ifndef RW_LABELING_H
+#define RW_LABELING_H
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "Node.h"
+#include "Cluster.h"
+#include "SparseMatrix.h"
+
+#define DELAY_NONE 0   //delays computed on the fly with max_delay
+#define DELAY_DENSE 1  //NxN delay matrix
+#define DELAY_SPARSE 2 //SparseMatrix delay matrix
+#define DELAY_CONE 3   //delays recomputed from each node's fan-in cone, no matrix
+#define DELAY_UNIT 4   //unit delay netlists: cone delays in 8/16 bit arrays sized by the longest path, no matrix
+
+//Delay matrix built once from the topologically sorted graph; read only afterwards so
+//several labeling runs may share it
+struct DelayData {
+    int mode;
+    int N;
+    int width;          //bytes per dense (or DELAY_UNIT cone) entry, the smallest that holds the longest path delay
+    bool unitDelay;     //every node with fan-in has delay 1
+    bool positiveDelay; //every node with fan-in has a delay above 0, so d(x, v) > 0 for all x in v's cone
+    void *dense;
+    size_t denseBytes;  //N * N * width, allocated with allocateLarge (LargeAlloc.h)
+    SparseMatrix *sparse;
+    void *mapped;       //read-only delay cache mapping (DelayCache.h) that dense or the sparse rows point into
+    size_t mappedBytes;
+
+    DelayData();
+    ~DelayData();
+    DelayData(const DelayData&) = delete;
+    DelayData& operator=(const DelayData&) = delete;
+    void release();
+    void allocateDense(); //zeroed N * N entries of width bytes
+    long long bytes() const;
+    //generic access; the labeling loops use the typed providers of DelayProvider.h instead
+    int get(uint32_t row, uint32_t col) const {
+        if (mode == DELAY_SPARSE) return sparse->get(row, col);
+        long long index = (long long) N * row + col;
+        if (width == 1) return ((uint8_t*) dense)[index];
+        if (width == 2) return ((uint16_t*) dense)[index];
+        return ((int*) dense)[index];
+    }
+};
+
+struct LabelingResult;
+
+//Parameters that only affect labeling and clustering (not parsing or the delay matrix)
+struct LabelingOptions {
+    int maxClusterSize;
+    int interClusterDelay;
+    int useLawler;
+    int useExp;
+    int useExp2;
+    int useGui;
+    int labelThreads = 1;          //threads that share the work on one giant cone (0 = one per core)
+    int parallelConeMin = 16384;   //smaller cones are labeled by a single thread
+    const uint32_t* tieRank = nullptr; //equal label_v values are ordered by tieRank[id] instead of the id (Locality.h)
+    //called from the labeling loop with the partial result at most once per checkpointIntervalMs
+    std::function<void(LabelingResult&)> checkpoint;
+    long long checkpointIntervalMs = 0;
+    //output streaming (OutputWriter.h): nodeLabeled(i) as soon as the label (and RW cluster) of master[i] is
+    //final, in topological order; clusterSelected(cl) as cl enters finalClusterList
+    std::function<void(size_t)> nodeLabeled;
+    std::function<void(const Cluster*)> clusterSelected;
+};
+
+//Everything a single labeling/clustering run produces; labels are indexed by node id so the
+//graph itself is never written to and can be shared between runs
+struct LabelingResult {
+    std::vector<int> labels;
+    std::vector<Cluster> clusters;
+    std::vector<Cluster*> finalClusterList;
+    std::vector<std::vector<Node*>> lHistory;
+    int maxLabel = 0;
+    int maxIODelay = 0;
+    int maxIODelayLawlerModified = 0;
+    long int clusterAreaCost = 0;
+    size_t labeledNodes = 0;   //nodes labeled in topological order; all of them unless interrupted.
+                               //computeLabels continues after a restored prefix (see Checkpoint.h)
+    bool interrupted = false;  //SIGINT stopped labeling or clustering early, the result is partial
+};
+
+//Per-run scratch arrays used while labeling (indexed by node id)
+struct LabelScratch {
+    std::vector<char> visited;
+    std::vector<int> label_v;
+    std::vector<int> coneDelay;
+    std::vector<uint8_t> coneDepth8;   //DELAY_UNIT cone delays for 1 and 2 byte widths
+    std::vector<uint16_t> coneDepth16;
+    std::vector<int> coneSize;   //|S| of every labeled node
+    std::vector<Node *> S;
+    std::vector<Node *> top;     //best candidates of S in labeling order
+    void resize(size_t n);
+};
+
+void addPredecessors(std::vector<Node *>&, Node*);
+void collectPredecessors(std::vector<Node *>&, Node*, std::vector<char>&);
+int max_delay(Node*, Node*, const std::vector<Node*>&);
+
+void analyzeDelays(std::vector<Node*>& master, DelayData& dd);
+//the rows of a delay matrix are independent: threads > 1 (0 = one per core) builds them in parallel
+void computeDelayMatrix(std::vector<Node*>& master, int N, bool useSparse, DelayData& dd, int threads = 1);
+void prepareDelays(std::vector<Node*>& master, int N, int mode, DelayData& dd, int threads = 1);
+void recordDelayMatrixMetrics(DelayData& dd);
+void initializeLabels(std::vector<Node*>& master, int N, LabelingOptions& opts, LabelingResult& res);
+void computeConeDelays(Node* v, std::vector<Node*>& S, std::vector<char>& visited, std::vector<int>& coneDelay);
+void labelNodeRW(Node* v, std::vector<Node*>& master, DelayData& dd, LabelingOptions& opts,
+                 std::vector<int>& labels, LabelScratch& scratch, Cluster& cl);
+void computeLabels(std::vector<Node*>& master, std::vector<Node*>& POs, DelayData& dd, LabelingOptions& opts, LabelingResult& res);
+void computeClusters(std::vector<Node*>& master, std::vector<Node*>& POs, LabelingOptions& opts, LabelingResult& res);
+void finalizeResult(LabelingOptions& opts, LabelingResult& res);
+void applyLabels(std::vector<Node*>& master, LabelingResult& res);
+
+#endif //RW_LABELING_H
@@ -0,0 +1,23 @@
+//
+// Allocation of the large delay tables: anonymous mappings with a transparent huge page hint
+//
+
+#ifndef RW_LARGEALLOC_H
+#define RW_LARGEALLOC_H
+
+#include <cstddef>
+
+#define HUGE_PAGE_BYTES ((size_t) 2 << 20) //x86-64 and arm64 transparent huge page size
+#define LARGE_ALLOC_MIN HUGE_PAGE_BYTES    //smaller blocks come from the heap
+
+//Blocks of at least LARGE_ALLOC_MIN bytes are mapped on their own, aligned to a huge page and marked
+//MADV_HUGEPAGE, so a sweep over a dense delay matrix needs one TLB entry per 2 MB instead of per 4 KB.
+//The pages are not touched here: the kernel backs each one when it is first written, on the memory node
+//of the writing thread, so a table filled by several threads ends up next to the threads that built it.
+//Every block comes back zeroed. Throws std::bad_alloc like new.
+void* allocateLarge(size_t bytes);
+void releaseLarge(void* p, size_t bytes); //bytes as passed to allocateLarge
+void setHugePages(bool enabled);          //false: plain pages (MADV_NOHUGEPAGE), to compare against
+long long hugePagesKB();                  //AnonHugePages of the process; only works on linux, -1 if unknown
+
+#endif //RW_LARGEALLOC_H
@@ -0,0 +1,34 @@
+//
+// Locality renumbering: a topological order that keeps connected logic close together in the id space
+//
+
+#ifndef RW_LOCALITY_H
+#define RW_LOCALITY_H
+
+#include <cstdint>
+#include <vector>
+#include "Node.h"
+
+//How far apart connected nodes are in an order (positions = ids after initializeLabels)
+struct LocalityMetrics {
+    double meanFaninDistance = 0;  //mean of pos(v) - pos(u) over every edge u -> v
+    uint64_t sparseRowCells = 0;   //sum over rows of the fan-out cone's column range, what SparseMatrix stores
+};
+
+struct LocalityStats {
+    LocalityMetrics before;
+    LocalityMetrics after;
+    bool applied = false;          //false if no candidate order beat the DFS order, which is then kept
+};
+
+LocalityMetrics measureLocality(std::vector<Node*>& master);
+
+//Replaces the DFS order of sortTopologically with a more local one when that lowers the sparse row cells:
+//POs whose fan-in cones start at the same logic are visited one after another (cone clustering) and the
+//fan-ins of every node are visited deepest level first, so each fan-in cone ends up in one contiguous
+//block right before its root. tieRank[new position] = old position: labeling breaks label_v ties by it
+//(LabelingOptions::tieRank) so the clusters are the same as without renumbering.
+void renumberForLocality(std::vector<Node*>& master, std::vector<Node*>& POs, std::vector<uint32_t>& tieRank,
+                         LocalityStats& stats);
+
+#endif //RW_LOCALITY_H
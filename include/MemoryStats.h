@@ -0,0 +1,39 @@
+//
+// Per-structure memory accounting and peak RSS samples at phase boundaries (--mem_report)
+//
+
+#ifndef RW_MEMORYSTATS_H
+#define RW_MEMORYSTATS_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include "Node.h"
+#include "Labeling.h"
+
+//VmRSS/VmHWM read right after a phase ended
+struct MemorySample {
+    std::string phase;
+    long long rssKB;
+    long long hwmKB;
+    long long hugePagesKB; //part of the RSS in transparent huge pages
+};
+
+//bytes held by the main data structures of one run (heap capacity, not just size)
+struct StructureBytes {
+    std::string name;
+    long long bytes;
+};
+
+struct MemoryReport {
+    std::vector<MemorySample> samples;
+    std::vector<StructureBytes> structures;
+    void sample(std::string phase);
+};
+
+long long procStatusKB(const char* field); //only works on linux; returns -1 if unknown
+void measureStructures(MemoryReport& report, std::vector<Node>& rawNodeList, std::vector<Node*>& master,
+                       DelayData& dd, LabelingResult& res);
+void writeMemoryReport(std::ostream& out, std::ostream& verboseFile, MemoryReport& report);
+
+#endif //RW_MEMORYSTATS_H
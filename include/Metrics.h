@@ -0,0 +1,69 @@
+//
+// Machine readable run metrics (--metrics out.json)
+//
+
+#ifndef RW_METRICS_H
+#define RW_METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define METRICS_CONE_BUCKETS 33 //log2 buckets for cone sizes up to 2^32
+
+//Counters are only touched when enabled, so a disabled run pays one predictable branch per update;
+//they are atomic because sweep and batch runs label on several threads
+struct Metrics {
+    bool enabled = false;
+
+    std::atomic<uint64_t> cones{0};               //fan-in cones collected by the labeling loops
+    std::atomic<uint64_t> coneNodes{0};           //sum of all cone sizes
+    std::atomic<uint64_t> coneMax{0};
+    std::atomic<uint64_t> coneHistogram[METRICS_CONE_BUCKETS];
+    std::atomic<uint64_t> sortedElements{0};      //elements passed to the label_v sort
+    std::atomic<uint64_t> chainReuses{0};         //cones taken from the candidates of a node's only fan-in
+    std::atomic<uint64_t> maxDelayCalls{0};       //on the fly longest path evaluations
+    std::atomic<uint64_t> queuePushes{0};         //nodes pushed onto the L set during the clustering phase
+    std::atomic<uint64_t> queueMax{0};
+    std::atomic<uint64_t> delayMatrixEntries{0};  //entries the delay matrix stores (including zeros)
+    std::atomic<uint64_t> delayMatrixNonZeros{0};
+    std::atomic<uint64_t> delayMatrixBytes{0};
+
+    struct Phase {
+        std::string circuit;
+        std::string name;
+        long long ns;
+    };
+    std::mutex phaseLock;
+    std::vector<Phase> phases;
+
+    struct Memory {
+        std::string circuit;
+        std::string name;  //structure, or peak RSS after a phase
+        long long bytes;
+    };
+    std::vector<Memory> memory;  //guarded by phaseLock
+
+    Metrics();
+};
+
+extern Metrics METRICS;
+
+inline void metricsAdd(std::atomic<uint64_t>& counter, uint64_t value){
+    if (METRICS.enabled) counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+inline void metricsMax(std::atomic<uint64_t>& counter, uint64_t value){
+    if (!METRICS.enabled) return;
+    uint64_t current = counter.load(std::memory_order_relaxed);
+    while (value > current && !counter.compare_exchange_weak(current, value, std::memory_order_relaxed));
+}
+
+void metricsRecordCone(uint64_t size);
+void metricsRecordPhase(std::string circuit, std::string phase, long long ns);
+void metricsRecordMemory(std::string circuit, std::string name, long long bytes);
+bool writeMetricsFile(std::string filename, std::vector<std::pair<std::string,std::string>>& parameters);
+
+#endif //RW_METRICS_H
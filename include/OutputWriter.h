@@ -0,0 +1,70 @@
+//
+// Background writer of the table, verbose and cluster output files, fed while labeling and clustering run
+//
+
+#ifndef RW_OUTPUTWRITER_H
+#define RW_OUTPUTWRITER_H
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Node.h"
+
+//Writes the same files as writeOutputFiles, but row by row as the results become final: node rows in
+//topological order as each node is labeled (LabelingOptions::nodeLabeled), then cluster rows in the order
+//the clusters enter finalClusterList (LabelingOptions::clusterSelected). The calling thread only copies
+//the node, label and member pointers into a batch; a writer thread formats and writes the batches, so
+//the output I/O overlaps labeling and clustering instead of following them. finish() writes whatever is
+//left and closes the files; the statistics appended to the verbose file afterwards follow as before.
+class OutputWriter {
+public:
+    OutputWriter(std::string circuitName, int maxClusterSize, int interClusterDelay, int piDelay, int poDelay,
+                 int nodeDelay, int useLawlerLabeling, int useGui, int useExp);
+    ~OutputWriter();
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    //every node of the topological order exactly once and in that order, before the first cluster
+    void node(const Node* n, int label, const std::vector<Node*>* members);
+    void cluster(const Node* root, const std::vector<Node*>& members);
+    size_t nodesWritten() const { return nodeCount; }
+    void finish();
+
+private:
+    struct Record {
+        const Node* node;      //the node of a node row, the root of a cluster row
+        int label;
+        bool isCluster;
+        size_t firstMember;    //members are memberPool[firstMember, firstMember + memberCount)
+        size_t memberCount;
+    };
+    struct Batch {
+        std::vector<Record> records;
+        std::vector<Node*> memberPool;
+    };
+
+    std::ofstream resultTable;
+    std::ofstream verboseResult;
+    std::ofstream clustrTable;
+    bool lawler;
+    bool tooLargeForTable;
+    bool clusterSection;       //writer thread: the cluster section header of the verbose file is written
+    size_t nodeCount;
+
+    Batch filling;             //calling thread only
+    Batch queued;              //handed over under lock, swapped out by the writer thread
+    std::mutex lock;
+    std::condition_variable wake;
+    bool done;
+    std::thread thread;
+
+    void add(const Node* n, int label, bool isCluster, const std::vector<Node*>* members);
+    void handOver(bool last);
+    void writerLoop();
+    void writeBatch(Batch& batch);
+};
+
+#endif //RW_OUTPUTWRITER_H
@@ -0,0 +1,31 @@
+//
+// Partitioned RW labeling: worker processes label a netlist through a POSIX shared memory segment
+//
+
+#ifndef RW_PARTITION_H
+#define RW_PARTITION_H
+
+#include <string>
+#include <vector>
+#include "Node.h"
+#include "Labeling.h"
+
+//The nodes are split into partitions by logic level (longest fan-in path in nodes): a node's fan-in cone
+//lies entirely in lower levels, so the nodes of one level can be labeled in any order by any worker once
+//every lower level is done. The forked workers inherit the read-only graph and delay data, claim chunks
+//of the current level from the shared segment, publish their labels and cluster members in it and meet
+//at a process-shared barrier before the next level. The calling process only coordinates: it reports
+//progress, stops the workers on SIGINT or when one of them dies, and merges the clusters in topological
+//order, so computeClusters and every output file see the same result as computeLabels would produce.
+struct PartitionStats {
+    int processes = 0;
+    int levels = 0;
+    size_t largestLevel = 0;
+};
+
+int partitionProcessCount(int requested);
+//RW only, after initializeLabels (with no restored prefix); false with error set if a worker failed
+bool computeLabelsPartitioned(std::vector<Node*>& master, DelayData& dd, LabelingOptions& opts, LabelingResult& res,
+                              int processes, PartitionStats& stats, std::string& error);
+
+#endif //RW_PARTITION_H
@@ -0,0 +1,62 @@
+//
+// Live progress of the long running loops (delay matrix, labeling, clustering) and SIGINT handling
+//
+
+#ifndef RW_PROGRESS_H
+#define RW_PROGRESS_H
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+
+//Progress lines go to stderr so stdout and the output files stay unchanged
+struct ProgressSettings {
+    bool enabled = false;
+    long long intervalMs = 1000;  //at most one line per interval and meter
+};
+
+extern ProgressSettings PROGRESS;
+extern volatile std::sig_atomic_t INTERRUPT_FLAG;
+
+//the first SIGINT asks the loops to stop after their current node, a second one kills the process
+void installInterruptHandler();
+inline bool interruptRequested(){ return INTERRUPT_FLAG != 0; }
+void requestInterrupt();
+void clearInterrupt();
+
+//Reports done/total items, throughput and ETA of one loop. update() is a counter decrement on most
+//calls; the clock is only read every stride calls and the stride adapts so that happens a few times
+//per interval. The ETA uses work units when a loop's items are not equally expensive (matrix rows).
+//A meter must only be updated by the thread that created it.
+class ProgressMeter {
+public:
+    ProgressMeter(const char* phase, const char* unit, uint64_t total, uint64_t totalWork = 0);
+    ProgressMeter(const ProgressMeter&) = delete;
+    ProgressMeter& operator=(const ProgressMeter&) = delete;
+
+    void setTotal(uint64_t total){ this->total = total; }
+    void update(uint64_t done){ if (on && --countdown == 0) tick(done, done); }
+    void update(uint64_t done, uint64_t work){ if (on && --countdown == 0) tick(done, work); }
+    //closing line with the final count, only if the loop ran long enough to report at all
+    void finish(uint64_t done);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+    bool on;
+    bool printed;
+    bool tty;
+    const char* phase;
+    const char* unit;
+    uint64_t total;
+    uint64_t totalWork;
+    uint64_t stride;
+    uint64_t countdown;
+    Clock::time_point start;
+    Clock::time_point lastCheck;
+    Clock::time_point lastPrint;
+
+    void tick(uint64_t done, uint64_t work);
+    void print(uint64_t done, uint64_t work, bool last);
+};
+
+#endif //RW_PROGRESS_H
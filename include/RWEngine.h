@@ -0,0 +1,101 @@
+//
+// RWEngine: in-process interface to RW/Lawler labeling and clustering (librw)
+//
+
+#ifndef RW_RWENGINE_H
+#define RW_RWENGINE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Node.h"
+#include "Cluster.h"
+#include "Labeling.h"
+#include "Locality.h"
+
+//Everything the command line options of rw control, with the same defaults
+struct RWOptions {
+    int maxClusterSize = 8;
+    int interClusterDelay = 3;
+    int piDelay = 0;
+    int poDelay = 1;
+    int nodeDelay = 1;
+    int delayMode = DELAY_SPARSE;  //DELAY_NONE, DELAY_DENSE, DELAY_SPARSE or DELAY_CONE (RW only)
+    bool unitDelayFastPath = true; //RW with a matrix or cone mode uses DELAY_UNIT when every gate has delay 1
+    int labelThreads = 1;          //threads sharing the work on giant fan-in cones and delay matrix rows (0 = one per core)
+    int parallelConeMin = 16384;   //cones with fewer nodes are labeled by one thread
+    bool useLawler = false;
+    bool useExp = false;
+    bool useExp2 = false;
+    bool useGui = false;           //keep the L set history for writeGUIFile
+    bool renumber = false;         //sortTopologically also runs renumberForLocality (same clusters, other order)
+};
+
+//Owns one netlist and the result of clustering it. The netlist is either parsed from a BLIF file or
+//built with addInput/addOutput/addGate/addLatch followed by buildNetlist. run() executes every phase;
+//the phase methods can also be called one by one (in the order of run()) to time or reuse them.
+//Nodes are stored by value and referenced by pointer everywhere, so an engine cannot be copied.
+class RWEngine {
+public:
+    explicit RWEngine(const RWOptions& opts = RWOptions());
+    RWEngine(const RWEngine&) = delete;
+    RWEngine& operator=(const RWEngine&) = delete;
+
+    const RWOptions& options() const { return opts; }
+    void setOptions(const RWOptions& opts);
+    const std::string& lastError() const { return error; }
+
+    //netlist input; loadBLIF and buildNetlist return false with lastError() set for a missing file or an
+    //undriven signal, and never print or exit
+    bool loadBLIF(const std::string& filename);
+    void addInput(const std::string& name);
+    void addOutput(const std::string& name);   //the signal must also be driven by addGate
+    void addGate(const std::string& name, const std::vector<std::string>& fanins);
+    void addLatch(const std::string& input, const std::string& output);
+    bool buildNetlist();
+    void clear();
+
+    //phases
+    bool sortTopologically();
+    void initializeLabels();
+    void computeDelays();
+    int matrixMode();         //DELAY_DENSE/DELAY_SPARSE if computeDelays would build that matrix, else DELAY_NONE
+    void computeLabels();
+    void computeClusters();
+    bool run();
+
+    //results, valid after run() (or the phases) until the netlist changes
+    const std::vector<Node*>& topologicalOrder() const { return master; }
+    const std::vector<Node*>& primaryOutputs() const { return POs; }
+    Node* findNode(const std::string& name) const;
+    int labelOf(const Node* n) const { return res.labels.at(n->id); }
+    const Cluster& clusterOf(const Node* n) const;
+    const std::vector<Cluster*>& finalClusters() const { return res.finalClusterList; }
+    int maxIODelay() const { return res.maxIODelay; }
+    const LocalityStats& localityStats() const { return locality; }
+    long int clusterAreaCost() const { return res.clusterAreaCost; }
+
+    //underlying structures, for callers that drive the free functions of Labeling.h/Eco.h themselves
+    std::vector<Node>& nodeList() { return rawNodeList; }
+    std::vector<Node*>& outputs() { return POs; }
+    std::vector<Node*>& order() { return master; }
+    DelayData& delays() { return delayData; }
+    LabelingOptions& labelingOptions() { return labelOpts; }
+    LabelingResult& result() { return res; }
+
+private:
+    RWOptions opts;
+    LabelingOptions labelOpts;
+    std::string error;
+    std::vector<Node> rawNodeList;
+    std::unordered_map<std::string, size_t> pending;  //names added since the last buildNetlist
+    bool linked = false;
+    std::vector<Node*> POs;
+    std::vector<Node*> master;
+    DelayData delayData;
+    LabelingResult res;
+    std::vector<uint32_t> tieRank;
+    LocalityStats locality;
+};
+
+#endif //RW_RWENGINE_H
@@ -0,0 +1,147 @@
+//
+// Binary result file (.rwb) for the RW/Lawler clustering application
+//
+
+#ifndef RW_RESULTFILE_H
+#define RW_RESULTFILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Node.h"
+#include "Cluster.h"
+
+//File layout (native byte order, every section 8 byte aligned):
+//  RWBHeader
+//  RWBNode[nodeCount]          node table in topological order (index == node id)
+//  RWBCluster[clusterCount]    every cluster formed during labeling
+//  uint32_t[finalCount]        indices into the cluster table of the final cluster list
+//  uint32_t[memberCount]       member node ids of all clusters (RWBCluster::memberOffset)
+//  uint32_t[inputCount]        input node ids of all clusters (RWBCluster::inputOffset)
+//  char[stringBytes]           node names (RWBNode::nameOffset), not null terminated
+//  uint32_t[nodeCount]         node ids sorted by name, for lookups by name
+//  uint64_t[nodeCount+1]       start of every node's fan-ins in the fan-in section (CSR index)
+//  uint32_t[faninCount]        fan-in node ids of all nodes
+//The header is versioned so readers can reject files they do not understand. Version 1 files end after the
+//names and their header has no faninCount..faninOffset fields; they are still read, without the name index
+//and fan-in sections (hasGraph() is false)
+#define RWB_MAGIC "RWCB"
+#define RWB_VERSION 2
+#define RWB_VERSION_NO_GRAPH 1
+#define RWB_ENDIAN_TAG 0x01020304u
+
+#define RWB_FLAG_LAWLER 0x1u
+#define RWB_FLAG_GUI    0x2u
+#define RWB_FLAG_EXP    0x4u
+
+struct RWBHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t endianTag;
+    uint32_t headerSize;
+    uint32_t flags;
+    int32_t maxClusterSize;
+    int32_t interClusterDelay;
+    int32_t piDelay;
+    int32_t poDelay;
+    int32_t nodeDelay;
+    int32_t maxIODelay;
+    int32_t reserved;
+    uint64_t nodeCount;
+    uint64_t clusterCount;
+    uint64_t finalCount;
+    uint64_t memberCount;
+    uint64_t inputCount;
+    uint64_t stringBytes;
+    uint64_t nodeOffset;
+    uint64_t clusterOffset;
+    uint64_t finalOffset;
+    uint64_t memberOffset;
+    uint64_t inputOffset;
+    uint64_t stringOffset;
+    uint64_t faninCount;
+    uint64_t nameIndexOffset;
+    uint64_t faninIndexOffset;
+    uint64_t faninOffset;
+    uint64_t fileSize;
+};
+
+#define RWB_V1_HEADER_SIZE (offsetof(RWBHeader, faninCount) + sizeof(uint64_t))
+
+struct RWBNode {
+    uint64_t nameOffset;
+    uint32_t nameLength;
+    int32_t delay;
+    int32_t label;
+    uint8_t isPI;
+    uint8_t isPO;
+    uint8_t pad[2];
+};
+
+struct RWBCluster {
+    uint32_t rootId;
+    uint32_t memberCount;
+    uint32_t inputCount;
+    uint32_t pad;
+    uint64_t memberOffset;
+    uint64_t inputOffset;
+};
+
+bool writeBinaryResultFile(std::string filename,
+                           std::vector<Node*>& topoNodeList,
+                           std::vector<Cluster>& clList,
+                           std::vector<Cluster*>& clListFinal,
+                           int& maxIODelay,
+                           int& cmdMaxClusterSize,
+                           int& cmdInterClusterDelay,
+                           int& cmdPiDelay,
+                           int& cmdPoDelay,
+                           int& cmdNodeDelay,
+                           int& cmdUseLawlerLabeling,
+                           int& cmdUseGui,
+                           int& cmdUseExp);
+
+//Read-only view of a .rwb file; the file is memory mapped and never copied. open() rejects files whose
+//sections, records or node ids are out of range, so the accessors need no checks of their own
+class ResultFileReader {
+private:
+    int fd;
+    const char *base;
+    size_t length;
+    std::string error;
+    RWBHeader hdr;  //copy of the file header, version 1 headers widened to the current layout
+
+    template <typename T> const T* section(uint64_t offset) const { return reinterpret_cast<const T*>(base + offset); }
+    bool fits(uint64_t offset, uint64_t count, uint64_t width) const;
+    void validate(); //sets error if any section, record or id in the file is out of range
+
+public:
+    ResultFileReader();
+    ~ResultFileReader();
+    ResultFileReader(const ResultFileReader&) = delete;
+    ResultFileReader& operator=(const ResultFileReader&) = delete;
+
+    bool open(std::string filename);
+    void close();
+    const std::string& lastError() const { return error; }
+
+    const RWBHeader& header() const { return hdr; }
+    bool hasGraph() const { return hdr.version >= 2; } //name index and fan-in sections present
+    uint64_t nodeCount() const { return header().nodeCount; }
+    uint64_t clusterCount() const { return header().clusterCount; }
+    uint64_t finalCount() const { return header().finalCount; }
+
+    const RWBNode& node(uint64_t id) const { return section<RWBNode>(header().nodeOffset)[id]; }
+    std::string nodeName(uint64_t id) const;
+    const RWBCluster& cluster(uint64_t idx) const { return section<RWBCluster>(header().clusterOffset)[idx]; }
+    const RWBCluster& finalCluster(uint64_t i) const { return cluster(section<uint32_t>(header().finalOffset)[i]); }
+    const uint32_t* members(const RWBCluster& c) const { return section<uint32_t>(header().memberOffset) + c.memberOffset; }
+    const uint32_t* inputs(const RWBCluster& c) const { return section<uint32_t>(header().inputOffset) + c.inputOffset; }
+    uint64_t faninCount(uint64_t id) const;
+    const uint32_t* fanins(uint64_t id) const;
+    //binary search over the name index (a linear search without it); returns false if no node has that name
+    bool findNode(const std::string& name, uint32_t& id) const;
+};
+
+#endif //RW_RESULTFILE_H
@@ -6,17 +6,38 @@
 #define RW_SPARSEMATRIX_H
 
 #include <iostream>
+#include <mutex>
+#include <vector>
+#include "LargeAlloc.h"
+
+#define SPARSE_POOL_INTS ((size_t) 1 << 20) //ints per row pool block (4 MB, two huge pages)
 
 //Sparse matrix holds a 2D matrix of ints
 //avoids storing 0 by using an offset and size variable to point to only the range of nonzero values in a matrix row
+//the row ranges are carved out of large pool blocks (allocateLarge) instead of one heap block per row
 class SparseMatrix{
 private:
     int rows, columns;
     int *offset;
     int *size;
     int **data;
+    std::mutex poolLock;
+    std::vector<std::pair<int*, size_t>> blocks; //pool blocks and their sizes in ints
+
+    int* newBlock(size_t ints){
+        int* block = (int*) allocateLarge(ints * sizeof(int));
+        std::lock_guard<std::mutex> guard(poolLock);
+        blocks.push_back(std::make_pair(block, ints));
+        return block;
+    }
 
 public:
+    //the unused part of the block a builder thread is filling; one per thread, rows are written in place
+    struct RowPool {
+        int* next = nullptr;
+        size_t left = 0;
+    };
+
     SparseMatrix(int rows, int columns){
         if (rows>0 && columns>0){
             this->rows = rows;
@@ -39,41 +60,47 @@ public:
         }
     }
     ~SparseMatrix(){
-        for(int r=0; r<rows; ++r){
-            delete[] data[r];
+        for (auto& b : blocks){
+            releaseLarge(b.first, b.second * sizeof(int));
         }
         delete[] offset;
         delete[] size;
         delete[] data;
         rows=columns=0;
     }
-    void set(int row, int column, int value){
-        if(row<0 || row>=rows || column < 0 || column >=columns) return; //out of bounds
-        if(size[row] ==0){ //no data on this row yet
-            if(value == 0) return; //no need to store a 0
-            data[row] = new int[1];
-            data[row][0] = value;
-            size[row] = 1;
-            offset[row] = column;
-            return;
-        }
-        if(column>=offset[row]+size[row]){ //new value comes after existing data in row
-            int newSize = column-offset[row]+1;
-            int* newRow = new int[newSize];
-            for(int i=0; i<size[row];++i){
-                newRow[i] = data[row][i];
+    //reserves the range [rowOffset, rowOffset + rowSize) of row (zeroed) and returns it for the caller to fill;
+    //for current RW every row is written once, rows may be written by different threads with their own pools
+    int* allocateRow(int row, int rowOffset, int rowSize, RowPool& pool){
+        if(row<0 || row>=rows || rowSize <= 0) return nullptr;
+        if((size_t) rowSize > pool.left){
+            if((size_t) rowSize >= SPARSE_POOL_INTS){ //a block of its own, the pool keeps its remainder
+                data[row] = newBlock(rowSize);
+                offset[row] = rowOffset;
+                size[row] = rowSize;
+                return data[row];
             }
-            for(int i=size[row]; i<newSize; ++i){
-                newRow[i] = 0;
-            }
-            newRow[column-offset[row]] = value;
-            delete[] data[row];
-            data[row] = newRow;
-            size[row] = newSize;
-            return;
+            pool.next = newBlock(SPARSE_POOL_INTS);
+            pool.left = SPARSE_POOL_INTS;
+        }
+        data[row] = pool.next;
+        offset[row] = rowOffset;
+        size[row] = rowSize;
+        pool.next += rowSize;
+        pool.left -= rowSize;
+        return data[row];
+    }
+    //uses row ranges stored elsewhere (a mapped delay cache) that outlive the matrix: offsets and sizes as
+    //written by save, values holds the ranges back to back; false if they do not fit the matrix
+    bool attachRows(const int* rowOffsets, const int* rowSizes, const int* values, long long valueCount){
+        long long used = 0;
+        for (int r=0; r<rows; ++r){
+            if (rowSizes[r] < 0 || rowSizes[r] > columns || used + rowSizes[r] > valueCount) return false;
+            offset[r] = rowOffsets[r];
+            size[r] = rowSizes[r];
+            data[r] = (rowSizes[r] > 0) ? (int*) values + used : nullptr;
+            used += rowSizes[r];
         }
-        std::cout << "UNSUPPORTED SPARSE MATRIX OPERATION" << std::endl;
-        //for current RW, only supports sequential insertion
+        return used == valueCount;
     }
     int get(int row, int column){
         if(row<0 || row >=rows) return 0;
@@ -81,6 +108,45 @@ public:
         if(index<0 || index>=size[row]) return 0;
         return data[row][index];
     }
+    //number of values held in row ranges (zeros inside a range included)
+    long long storedEntries(){
+        long long total = 0;
+        for (int r=0; r<rows; ++r) total += size[r];
+        return total;
+    }
+    long long nonZeros(){
+        long long total = 0;
+        for (int r=0; r<rows; ++r){
+            for (int i=0; i<size[r]; ++i){
+                if (data[r][i] != 0) ++total;
+            }
+        }
+        return total;
+    }
+    long long bytes(){
+        return storedEntries() * sizeof(int) + (long long) rows * (2 * sizeof(int) + sizeof(int*));
+    }
+    //raw row ranges (offset, size, values) for checkpoint files; load expects a matrix of the same shape
+    void save(std::ostream& out){
+        out.write((const char*) offset, sizeof(int) * rows);
+        out.write((const char*) size, sizeof(int) * rows);
+        for (int r=0; r<rows; ++r){
+            out.write((const char*) data[r], sizeof(int) * size[r]);
+        }
+    }
+    bool load(std::istream& in){
+        in.read((char*) offset, sizeof(int) * rows);
+        in.read((char*) size, sizeof(int) * rows);
+        RowPool pool;
+        for (int r=0; r<rows && in; ++r){
+            data[r] = nullptr;
+            if (size[r] < 0 || size[r] > columns) return false;
+            if (size[r] == 0) continue;
+            allocateRow(r, offset[r], size[r], pool);
+            in.read((char*) data[r], sizeof(int) * size[r]);
+        }
+        return (bool) in;
+    }
 
 };
 
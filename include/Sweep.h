@@ -0,0 +1,40 @@
+//
+// In-process parameter sweep over max cluster size / inter cluster delay
+//
+
+#ifndef RW_SWEEP_H
+#define RW_SWEEP_H
+
+#include <string>
+#include <vector>
+#include "Node.h"
+#include "Labeling.h"
+
+//One labeling + clustering run of the sweep
+struct SweepPoint {
+    LabelingOptions opts;
+    int numClusters = 0;
+    int maxIODelay = 0;
+    int maxIODelayLawlerModified = 0;
+    long int clusterAreaCost = 0;
+    long long labelTimeUs = 0;
+    long long clusterTimeUs = 0;
+    bool completed = false;   //false if SIGINT stopped the sweep before or during this point
+};
+
+//Times of the phases shared by every sweep point (microseconds)
+struct SweepSharedTimes {
+    long long parseUs = 0;
+    long long topoUs = 0;
+    long long delayMatrixUs = 0;
+};
+
+std::vector<int> parseIntList(std::string str);
+std::vector<SweepPoint> buildSweepPoints(std::vector<int>& sizes, std::vector<int>& delays,
+                                         bool includeRW, bool includeLawler, bool includeExp);
+int sweepWorkerCount(int requested, int N, std::vector<SweepPoint>& points);
+void runSweep(std::vector<Node*>& master, std::vector<Node*>& POs, int N, DelayData& dd,
+              std::vector<SweepPoint>& points, int jobs);
+void writeSweepSummary(std::string filename, std::vector<SweepPoint>& points, SweepSharedTimes& shared, int N);
+
+#endif //RW_SWEEP_H
@@ -0,0 +1,63 @@
+//
+// Work-stealing task pool used to split the work on a single huge fan-in cone
+//
+
+#ifndef RW_TASKPOOL_H
+#define RW_TASKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Every worker owns a deque: it pushes and pops split-off ranges at the back, idle workers steal the
+//oldest (largest) range from the front of another worker's deque. The thread that created the pool
+//is worker 0 and takes part in every parallelFor it starts. parallelFor calls must not be nested
+//and only the creating thread may start them.
+class TaskPool {
+public:
+    typedef std::function<void(size_t, size_t)> RangeBody;
+
+    explicit TaskPool(int threads);
+    ~TaskPool();
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    int size() const { return queues.size(); }
+    //runs body(lo, hi) on disjoint subranges covering [begin, end), none longer than grain
+    void parallelFor(size_t begin, size_t end, size_t grain, const RangeBody& body);
+
+private:
+    struct Range {
+        size_t lo;
+        size_t hi;
+    };
+    struct Queue {
+        std::mutex lock;
+        std::deque<Range> ranges;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    const RangeBody *body;
+    size_t grain;
+    std::atomic<size_t> pending;  //ranges of the current parallelFor not finished yet
+    std::atomic<int> queued;      //ranges waiting in any deque
+    bool stop;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+
+    void push(int self, Range r);
+    bool take(int self, Range& r);
+    void execute(int self, Range r);
+    void workerLoop(int self);
+};
+
+int labelThreadCount(int requested);
+
+#endif //RW_TASKPOOL_H
@@ -0,0 +1,51 @@
+//
+// Timeline tracing in Chrome trace-event format (--trace out.json, open in chrome://tracing or Perfetto)
+//
+
+#ifndef RW_TRACE_H
+#define RW_TRACE_H
+
+#include <chrono>
+#include <string>
+
+typedef std::chrono::high_resolution_clock::time_point TraceTime;
+
+//Tracing settings; spans are buffered per thread and only written out at the end of the run
+struct TraceSettings {
+    bool enabled = false;
+    int sampleRate = 100;             //sampled spans: keep one in sampleRate ...
+    long long keepNs = 1000000;       //... plus every span that took at least keepNs
+};
+
+extern TraceSettings TRACE;
+
+//Scoped span: records [construction, destruction) on the calling thread
+//name and cat must be string literals; args are only worth building when active() is true
+class TraceSpan {
+public:
+    TraceSpan(const char* name, const char* cat, bool sampled = false);
+    ~TraceSpan();
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+    bool active() const { return on; }
+    void arg(const char* key, long long value);
+    void arg(const char* key, const std::string& value);
+
+private:
+    bool on;
+    bool sampled;
+    const char* name;
+    const char* cat;
+    TraceTime start;
+    std::string args;
+};
+
+//span for a phase that was already timed with high_resolution_clock
+void traceComplete(const char* name, const char* cat, TraceTime start, TraceTime end, std::string circuit);
+//counter track (e.g. clustering queue length)
+void traceCounter(const char* name, long long value);
+//label of the calling thread in the viewer
+void traceThreadName(std::string name);
+bool writeTraceFile(std::string filename);
+
+#endif //RW_TRACE_H
@@ -0,0 +1,225 @@
+//
+// Approximate RW labeling: capped fan-in cones and a time budget, with proven bounds on the max IO delay
+//
+
+#include "../include/Approximate.h"
+#include "../include/common.h"
+#include "../include/Metrics.h"
+#include "../include/Progress.h"
+#include "../include/Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+#define BUDGET_STRIDE 256 //labeled nodes between two looks at the budget clock
+#define NO_PI_PATH INT_MIN //piPath of a node without a PI in its fan-in cone
+
+#define CANDIDATE 2 //state of a node taken into the candidates of v
+#define BOUNDARY 1  //fan-in of v or of a candidate that was left out
+
+//Proof sketch for both labels, with label_v(x) = label(x) + d(x, v) and S = every ancestor of v:
+//the exact label is min over clusters C of max(label_v of the PIs in C, label_v(x) + icd for x in S \ C),
+//reached by the K-1 best x; it grows with the labels of S. For a left-out ancestor x, the last left-out
+//node b on a longest path from x to v is a boundary node, so label_v(x) <= worst[b] + d_in(b, v), where
+//worst[b] bounds label(y) + d(y, b) for b and all its ancestors y and d_in only follows paths that leave b
+//through a candidate or v. The upper label evaluates one particular C with upper labels and charges the
+//left-out ancestors that way. The lower label uses that the K-th best label_v of S is at least the K-th
+//best of any part of it (with lower labels), and that a PI is either in C or charged label_v + icd.
+struct ApproxLabeler {
+    std::vector<Node*>& master;
+    LabelingOptions& opts;
+    LabelingResult& res;
+    std::vector<int>& upper;      //= res.labels
+    std::vector<int> lower;
+    std::vector<int> worst;       //max of upper(y) + d(y, x) over x and every ancestor y
+    std::vector<int> piPath;      //max of label(p) + d(p, x) over the PIs p in the cone of x
+    std::vector<int> delay;       //d(x, v) of the candidates, d_in(b, v) of the boundary
+    std::vector<int> label_v;     //upper label_v of the candidates, lower label_v of candidates and boundary
+    std::vector<char> state;
+    std::vector<Node*> frontier;  //max heap on the topological position
+    std::vector<Node*> candidates;
+    std::vector<Node*> ranked;
+    size_t k;
+
+    ApproxLabeler(std::vector<Node*>& master, LabelingOptions& opts, LabelingResult& res)
+        : master(master), opts(opts), res(res), upper(res.labels) {
+        size_t N = res.labels.size();
+        lower = upper;
+        worst.assign(N, 0);
+        piPath.assign(N, NO_PI_PATH);
+        delay.assign(N, 0);
+        label_v.assign(N, 0);
+        state.assign(N, 0);
+        k = (opts.maxClusterSize > 1) ? opts.maxClusterSize : 1;
+    }
+
+    static bool laterFirst(const Node* lhs, const Node* rhs){ return lhs->id < rhs->id; }
+
+    void push(Node* x){
+        if (state[x->id]) return;
+        state[x->id] = BOUNDARY;
+        frontier.push_back(x);
+        std::push_heap(frontier.begin(), frontier.end(), laterFirst);
+    }
+
+    //longest path delay to v through candidates only; successors of x that are v's ancestors have higher
+    //positions, so every candidate among them was taken (and got its delay) before x
+    int delayThroughCandidates(Node* x, Node* v){
+        int best = 0;
+        for (auto s : x->next){
+            int d;
+            if (s == v) d = v->delay;
+            else if (state[s->id] == CANDIDATE) d = delay[s->id] + s->delay;
+            else continue;
+            best = (d > best) ? d : best;
+        }
+        return best;
+    }
+
+    //returns true if the whole cone of v fit in the limit (the label and cluster are exact)
+    bool label(Node* v, size_t limit, Cluster& cl){
+        cl.members.push_back(v);
+        if (v->prev.empty()){
+            //PIs keep their initial label, like in computeLabels
+            worst[v->id] = upper[v->id];
+            piPath[v->id] = v->isPI ? upper[v->id] : NO_PI_PATH;
+            generateInputSet(cl);
+            return true;
+        }
+        frontier.clear();
+        candidates.clear();
+        for (auto p : v->prev) push(p);
+        while (!frontier.empty() && candidates.size() < limit){
+            std::pop_heap(frontier.begin(), frontier.end(), laterFirst);
+            Node* x = frontier.back();
+            frontier.pop_back();
+            state[x->id] = CANDIDATE;
+            delay[x->id] = delayThroughCandidates(x, v);
+            candidates.push_back(x);
+            for (auto p : x->prev) push(p);
+        }
+        for (auto b : frontier){
+            delay[b->id] = delayThroughCandidates(b, v);
+        }
+        metricsRecordCone(candidates.size());
+        bool exact = frontier.empty();
+
+        //upper label: cluster(v) takes the K-1 best candidates, ordered as in labelNodeRW
+        for (auto x : candidates){
+            label_v[x->id] = upper[x->id] + delay[x->id];
+        }
+        const uint32_t* rank = opts.tieRank;
+        auto order = [&](const Node* lhs, const Node* rhs){
+            if (label_v[lhs->id] == label_v[rhs->id]){
+                return rank ? rank[lhs->id] > rank[rhs->id] : lhs->id > rhs->id;
+            }
+            return label_v[lhs->id] > label_v[rhs->id];
+        };
+        size_t best = std::min(k, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + best, candidates.end(), order);
+        size_t next = std::min(k - 1, candidates.size());
+        cl.members.insert(cl.members.end(), candidates.begin(), candidates.begin() + next);
+        int L1 = 0;
+        for (size_t i = 0; i < next; ++i){
+            if (candidates[i]->isPI && label_v[candidates[i]->id] > L1) L1 = label_v[candidates[i]->id];
+        }
+        int L2 = (next < candidates.size()) ? label_v[candidates[next]->id] + opts.interClusterDelay : 0;
+        for (auto b : frontier){
+            int charged = worst[b->id] + delay[b->id] + opts.interClusterDelay;
+            L2 = (charged > L2) ? charged : L2;
+        }
+        upper[v->id] = (L1 > L2) ? L1 : L2;
+
+        //lower label: the K-th best lower label_v of the candidates and the boundary
+        ranked.assign(candidates.begin(), candidates.end());
+        ranked.insert(ranked.end(), frontier.begin(), frontier.end());
+        for (auto x : ranked){
+            label_v[x->id] = lower[x->id] + delay[x->id];
+        }
+        auto byLower = [&](const Node* lhs, const Node* rhs){ return label_v[lhs->id] > label_v[rhs->id]; };
+        int lowerL1 = 0;
+        int lowerL2 = 0;
+        next = std::min(k - 1, ranked.size());
+        if (next < ranked.size()){
+            std::nth_element(ranked.begin(), ranked.begin() + next, ranked.end(), byLower);
+            lowerL2 = label_v[ranked[next]->id] + opts.interClusterDelay;
+        }
+        if (exact){
+            //the whole cone was ranked, so this is the RW label of v over the lower labels
+            for (size_t i = 0; i < next; ++i){
+                if (ranked[i]->isPI && label_v[ranked[i]->id] > lowerL1) lowerL1 = label_v[ranked[i]->id];
+            }
+        }
+        int bound = std::max(lowerL1, lowerL2);
+        finishNode(v);
+        lower[v->id] = std::max(bound, piPath[v->id]);
+
+        for (auto x : candidates) state[x->id] = 0;
+        for (auto b : frontier) state[b->id] = 0;
+        generateInputSet(cl);
+        return exact;
+    }
+
+    //worst and piPath of v from its fan-ins, once upper[v] is known
+    void finishNode(Node* v){
+        int w = upper[v->id];
+        int p = NO_PI_PATH;
+        for (auto u : v->prev){
+            w = std::max(w, worst[u->id] + v->delay);
+            if (piPath[u->id] != NO_PI_PATH) p = std::max(p, piPath[u->id] + v->delay);
+        }
+        worst[v->id] = w;
+        piPath[v->id] = p;
+    }
+};
+
+void computeLabelsApproximate(std::vector<Node*>& master, LabelingOptions& opts, LabelingResult& res,
+                              int coneLimit, long long budgetMs, ApproxStats& stats){
+    TraceSpan span("approximate_labeling", "labeling");
+    ApproxLabeler labeler(master, opts, res);
+    size_t limit = (coneLimit > 0) ? (size_t) coneLimit : master.size();
+    stats = ApproxStats();
+    res.maxLabel = 0;
+    res.maxIODelay = 0;
+    res.clusters.clear();
+    res.clusters.reserve(master.size());
+    res.interrupted = false;
+
+    auto start = std::chrono::steady_clock::now();
+    int countdown = BUDGET_STRIDE;
+    ProgressMeter progress("labeling", "nodes", master.size());
+    for (size_t i = 0; i < master.size(); ++i){
+        if (interruptRequested()) break;
+        progress.update(i);
+        if (budgetMs > 0 && limit > 0 && --countdown == 0){
+            countdown = BUDGET_STRIDE;
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            if (elapsed.count() >= budgetMs) limit = 0;
+        }
+        Node* v = master[i];
+        Cluster cl(v->id);
+        if (!labeler.label(v, limit, cl)){
+            if (limit == 0) ++stats.budgetNodes;
+            else ++stats.cutCones;
+        }
+        res.maxLabel = std::max(res.maxLabel, res.labels[v->id]);
+        stats.lowerBound = std::max(stats.lowerBound, labeler.lower[v->id]);
+        res.clusters.push_back(cl);
+        res.labeledNodes = res.clusters.size();
+        if (opts.nodeLabeled) opts.nodeLabeled(i);
+    }
+    progress.finish(res.labeledNodes);
+    stats.upperBound = res.maxLabel;
+    if (res.labeledNodes < master.size()){
+        //stopped by SIGINT: nodes that were not reached keep their initial label and an empty cluster
+        res.interrupted = true;
+        for (size_t i = res.clusters.size(); i < master.size(); ++i){
+            res.clusters.push_back(Cluster(master[i]->id));
+        }
+    }
+    if (span.active()){
+        span.arg("cone_limit", coneLimit);
+        span.arg("cut_cones", (long long) stats.cutCones);
+        span.arg("budget_nodes", (long long) stats.budgetNodes);
+    }
+}
@@ -0,0 +1,178 @@
+//
+// Batch mode: cluster many BLIF netlists in one process on a worker pool
+//
+
+#include "../include/Batch.h"
+#include "../include/Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <mutex>
+#include <thread>
+#include <dirent.h>
+#include <sys/stat.h>
+
+static bool endsWith(const std::string& str, const std::string& suffix){
+    return str.length() >= suffix.length() && str.compare(str.length() - suffix.length(), suffix.length(), suffix) == 0;
+}
+
+static std::string circuitNameOf(const std::string& file){
+    //Description: file name without directory and .blif extension (output files are written to the working directory)
+    std::size_t slash = file.find_last_of('/');
+    std::string name = (slash == std::string::npos) ? file : file.substr(slash + 1);
+    if (endsWith(name, ".blif")){
+        name = name.substr(0, name.length() - 5);
+    }
+    return name;
+}
+
+static std::string parentDirOf(const std::string& file){
+    std::size_t slash = file.find_last_of('/');
+    if (slash == std::string::npos) return "";
+    std::string dir = file.substr(0, slash);
+    std::size_t parentSlash = dir.find_last_of('/');
+    return (parentSlash == std::string::npos) ? dir : dir.substr(parentSlash + 1);
+}
+
+static void makeNamesUnique(std::vector<BatchJob>& batch){
+    //Description: netlists with the same base name (a/x.blif, b/x.blif) would write the same output files from
+    //two workers at once; they get their parent directory as a prefix (a_x, b_x), and a counter if that is not enough
+    std::map<std::string, int> count;
+    for (auto& job : batch){
+        ++count[job.stats.circuitName];
+    }
+    for (auto& job : batch){
+        std::string parent = parentDirOf(job.file);
+        if (count[job.stats.circuitName] > 1 && parent != "" && parent != "." && parent != ".."){
+            job.stats.circuitName = parent + "_" + job.stats.circuitName;
+        }
+    }
+    std::set<std::string> used;
+    for (auto& job : batch){
+        std::string name = job.stats.circuitName;
+        for (int n = 2; used.count(name) > 0; ++n){
+            name = job.stats.circuitName + "_" + std::to_string(n);
+        }
+        used.insert(name);
+        job.stats.circuitName = name;
+    }
+}
+
+std::vector<BatchJob> collectBatchFiles(std::string path){
+    //Description: path is either a directory (every *.blif in it) or a text file listing one BLIF per line
+    std::vector<std::string> files;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0){
+        return std::vector<BatchJob>();
+    }
+    if (S_ISDIR(st.st_mode)){
+        DIR *dir = opendir(path.c_str());
+        if (dir != nullptr){
+            struct dirent *entry;
+            while ((entry = readdir(dir)) != nullptr){
+                std::string name = entry->d_name;
+                if (endsWith(name, ".blif")){
+                    files.push_back(path + "/" + name);
+                }
+            }
+            closedir(dir);
+        }
+    }
+    else {
+        std::ifstream listFile(path);
+        std::string line;
+        while (std::getline(listFile, line)){
+            std::size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#') continue;
+            std::size_t last = line.find_last_not_of(" \t\r");
+            files.push_back(line.substr(first, last - first + 1));
+        }
+    }
+
+    std::vector<BatchJob> batch;
+    for (auto& f : files){
+        BatchJob job;
+        job.file = f;
+        job.stats.circuitName = circuitNameOf(f);
+        if (stat(f.c_str(), &st) == 0){
+            job.fileBytes = st.st_size;
+        }
+        batch.push_back(job);
+    }
+    makeNamesUnique(batch);
+    //largest netlists first so that no long run starts at the end of the batch
+    std::stable_sort(batch.begin(), batch.end(), [](const BatchJob& a, const BatchJob& b){
+        return a.fileBytes > b.fileBytes;
+    });
+    return batch;
+}
+
+int batchWorkerCount(int requested, std::vector<BatchJob>& batch){
+    int jobs = requested;
+    if (jobs <= 0){
+        jobs = std::thread::hardware_concurrency();
+    }
+    if (jobs > (int) batch.size()) jobs = batch.size();
+    return (jobs < 1) ? 1 : jobs;
+}
+
+void runBatch(std::vector<BatchJob>& batch, int jobs, std::function<void(BatchJob&)> runOne){
+    //Description: workers take the next job from the (size sorted) list until it is exhausted
+    std::atomic<size_t> nextJob(0);
+    auto worker = [&](){
+        while (true){
+            size_t i = nextJob++;
+            if (i >= batch.size()) break;
+            runOne(batch.at(i));
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t=1; t < jobs; ++t){
+        threads.push_back(std::thread([&worker, t](){
+            traceThreadName("batch worker " + std::to_string(t));
+            worker();
+        }));
+    }
+    worker();
+    for (auto& t : threads){
+        t.join();
+    }
+}
+
+void writeBatchReport(std::string filename, std::vector<BatchJob>& batch){
+    std::ofstream report;
+    report.open(filename);
+    report << "CIRCUIT,FILE,STATUS,NODES,CLUSTERS,MAX IO PATH DELAY,CLUSTERED AREA,AREA FACTOR,"
+           << "PARSING (us),TOPOLOGICAL SORTING (us),DELAY MATRIX (us),LABEL AND INITIAL CLUSTERING (us),CLUSTERING (us),TOTAL (us),ERROR" << std::endl;
+    for (auto& job : batch){
+        CircuitStats& st = job.stats;
+        report << st.circuitName << "," << job.file << "," << (st.ok ? "OK" : "FAILED") << ","
+               << st.nodes << "," << st.clusters << "," << st.maxIODelay << "," << st.clusterAreaCost << ","
+               << ((st.nodes > 0) ? ((float) st.clusterAreaCost)/((float) st.nodes) : 0.0f) << ","
+               << st.parseUs << "," << st.topoUs << "," << st.delayMatrixUs << ","
+               << st.labelUs << "," << st.clusterUs << "," << st.totalUs << ",\"" << st.error << "\"" << std::endl;
+    }
+    report.close();
+}
+
+void printBatchReport(std::vector<BatchJob>& batch, long long wallUs){
+    std::cout << "\n------------------------------------\nBATCH STATISTICS:" << std::endl;
+    std::cout << "CIRCUIT\tNODES\tCLUSTERS\tMAX IO PATH DELAY\tAREA FACTOR\tTOTAL TIME (ms)" << std::endl;
+    long long cpuUs = 0;
+    for (auto& job : batch){
+        CircuitStats& st = job.stats;
+        if (!st.ok){
+            std::cout << st.circuitName << "\tFAILED" << ((st.error != "") ? " (" + st.error + ")" : "") << std::endl;
+            continue;
+        }
+        std::cout << st.circuitName << "\t" << st.nodes << "\t" << st.clusters << "\t" << st.maxIODelay << "\t"
+                  << ((float) st.clusterAreaCost)/((float) st.nodes) << "\t" << st.totalUs/1000 << std::endl;
+        cpuUs += st.totalUs;
+    }
+    std::cout << "SUM OF CIRCUIT TIMES:\t" << cpuUs/1000 << "ms" << std::endl;
+    std::cout << "BATCH WALL TIME:\t" << wallUs/1000 << "ms" << std::endl;
+    std::cout << "Report written to output_batch_report.csv" << std::endl;
+}
@@ -0,0 +1,225 @@
+//
+// Checkpoint and resume of the labeling phase (--checkpoint / --resume)
+//
+
+#include "../include/Checkpoint.h"
+#include "../include/common.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#define CHECKPOINT_MAGIC "RWCK"
+#define CHECKPOINT_VERSION 1
+#define DELAY_CHECKPOINT_MAGIC "RWCD"
+#define DELAY_CHECKPOINT_VERSION 1
+
+static void writeInt(std::ofstream& out, int32_t value){
+    out.write((const char*) &value, sizeof(value));
+}
+
+static int32_t readInt(std::ifstream& in){
+    int32_t value = 0;
+    in.read((char*) &value, sizeof(value));
+    return value;
+}
+
+template <typename T>
+static void writeArray(std::ofstream& out, const std::vector<T>& values){
+    out.write((const char*) values.data(), values.size() * sizeof(T));
+}
+
+template <typename T>
+static void readArray(std::ifstream& in, std::vector<T>& values, size_t count){
+    values.resize(count);
+    in.read((char*) values.data(), count * sizeof(T));
+}
+
+static uint64_t hashNames(std::vector<Node*>& master){
+    //FNV-1a over every name, each followed by a 0 byte
+    uint64_t hash = 14695981039346656037ULL;
+    for (auto n : master){
+        for (unsigned char c : n->strID){
+            hash = (hash ^ c) * 1099511628211ULL;
+        }
+        hash = hash * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static bool replaceFile(std::string tmpName, std::string filename){
+    return std::rename(tmpName.c_str(), filename.c_str()) == 0;
+}
+
+bool writeCheckpoint(std::string filename, std::vector<Node>& rawNodeList, std::vector<Node*>& master,
+                     LabelingResult& res, LabelingOptions& opts, int piDelay, int poDelay, int nodeDelay){
+    //Description: stores the topological order and everything labeled so far so --resume can continue from here
+    std::string tmpName = filename + ".tmp";
+    std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    out.write(CHECKPOINT_MAGIC, 4);
+    writeInt(out, CHECKPOINT_VERSION);
+    writeInt(out, opts.maxClusterSize);
+    writeInt(out, opts.interClusterDelay);
+    writeInt(out, piDelay);
+    writeInt(out, poDelay);
+    writeInt(out, nodeDelay);
+    writeInt(out, opts.useLawler);
+    writeInt(out, master.size());
+    uint64_t nameHash = hashNames(master);
+    out.write((const char*) &nameHash, sizeof(nameHash));
+    std::vector<uint32_t> order(master.size());
+    for (size_t i=0; i < master.size(); ++i){
+        order[i] = master[i] - rawNodeList.data();
+    }
+    writeArray(out, order);
+    uint64_t labeled = res.labeledNodes;
+    out.write((const char*) &labeled, sizeof(labeled));
+    writeInt(out, res.maxLabel);
+    writeInt(out, res.maxIODelay);
+    writeArray(out, res.labels);
+    if (!opts.useLawler){
+        for (size_t i=0; i < labeled; ++i){
+            Cluster& cl = res.clusters.at(i);
+            writeInt(out, cl.members.size());
+            for (auto mem : cl.members){
+                writeInt(out, mem->id);
+            }
+        }
+    }
+    out.close();
+    if (!out) return false;
+    return replaceFile(tmpName, filename);
+}
+
+bool loadCheckpoint(std::string filename, CheckpointState& state){
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) return false;
+    char magic[4];
+    in.read(magic, 4);
+    if (!in || memcmp(magic, CHECKPOINT_MAGIC, 4) != 0 || readInt(in) != CHECKPOINT_VERSION) return false;
+    state.maxClusterSize = readInt(in);
+    state.interClusterDelay = readInt(in);
+    state.piDelay = readInt(in);
+    state.poDelay = readInt(in);
+    state.nodeDelay = readInt(in);
+    state.useLawler = readInt(in);
+    int count = readInt(in);
+    if (!in || count < 0) return false;
+    in.read((char*) &state.nameHash, sizeof(state.nameHash));
+    readArray(in, state.order, count);
+    in.read((char*) &state.labeledNodes, sizeof(state.labeledNodes));
+    state.maxLabel = readInt(in);
+    state.maxIODelay = readInt(in);
+    readArray(in, state.labels, count);
+    if (!in || state.labeledNodes > (uint64_t) count) return false;
+    state.members.clear();
+    if (!state.useLawler){
+        state.members.resize(state.labeledNodes);
+        for (auto& m : state.members){
+            int size = readInt(in);
+            if (!in || size < 0 || size > count) return false;
+            readArray(in, m, size);
+        }
+    }
+    return (bool) in;
+}
+
+bool writeDelayCheckpoint(std::string filename, DelayData& dd){
+    //Description: the dense or sparse delay matrix, so a resumed run does not rebuild it
+    if (dd.mode != DELAY_DENSE && dd.mode != DELAY_SPARSE) return false;
+    std::string tmpName = filename + ".tmp";
+    std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    out.write(DELAY_CHECKPOINT_MAGIC, 4);
+    writeInt(out, DELAY_CHECKPOINT_VERSION);
+    writeInt(out, dd.mode);
+    writeInt(out, dd.N);
+    writeInt(out, dd.width);
+    writeInt(out, dd.unitDelay);
+    writeInt(out, dd.positiveDelay);
+    if (dd.mode == DELAY_DENSE){
+        out.write((const char*) dd.dense, dd.bytes());
+    }
+    else {
+        dd.sparse->save(out);
+    }
+    out.close();
+    if (!out) return false;
+    return replaceFile(tmpName, filename);
+}
+
+bool loadDelayCheckpoint(std::string filename, int N, DelayData& dd){
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) return false;
+    char magic[4];
+    in.read(magic, 4);
+    if (!in || memcmp(magic, DELAY_CHECKPOINT_MAGIC, 4) != 0 || readInt(in) != DELAY_CHECKPOINT_VERSION) return false;
+    int mode = readInt(in);
+    if (readInt(in) != N || (mode != DELAY_DENSE && mode != DELAY_SPARSE)) return false;
+    dd.release();
+    dd.N = N;
+    dd.width = readInt(in);
+    dd.unitDelay = readInt(in);
+    dd.positiveDelay = readInt(in);
+    if (dd.width != 1 && dd.width != 2 && dd.width != (int) sizeof(int)) return false;
+    if (mode == DELAY_DENSE){
+        dd.allocateDense();
+        in.read((char*) dd.dense, dd.denseBytes);
+    }
+    else {
+        dd.sparse = new SparseMatrix(N, N);
+        if (!dd.sparse->load(in)) in.setstate(std::ios::failbit);
+    }
+    dd.mode = mode;
+    if (!in){
+        dd.release();
+        return false;
+    }
+    return true;
+}
+
+void removeCheckpoint(std::string filename){
+    //Description: once labeling has finished there is nothing left to resume; the .delays file can be as
+    //large as the delay matrix, so it is not left behind either
+    std::remove(filename.c_str());
+    std::remove((filename + ".delays").c_str());
+}
+
+bool restoreCheckpointOrder(CheckpointState& state, std::vector<Node>& rawNodeList, std::vector<Node*>& master){
+    //same state as sortTopologically leaves behind: only nodes in master are visited
+    master.clear();
+    for (auto& n : rawNodeList){
+        n.visited = false;
+    }
+    for (auto index : state.order){
+        if (index >= rawNodeList.size() || rawNodeList[index].visited) return false;
+        rawNodeList[index].visited = true;
+        master.push_back(&rawNodeList[index]);
+    }
+    if (hashNames(master) != state.nameHash) return false;
+    uint32_t id = 0;
+    for (auto node : master){
+        node->id = id++;
+    }
+    return true;
+}
+
+void restoreCheckpointLabels(CheckpointState& state, std::vector<Node*>& master, LabelingResult& res){
+    //Description: the rest of the labels keep their initial values, computeLabels continues after labeledNodes
+    res.labels = state.labels;
+    res.maxLabel = state.maxLabel;
+    res.maxIODelay = state.maxIODelay;
+    res.labeledNodes = state.labeledNodes;
+    res.clusters.clear();
+    if (!state.useLawler){
+        res.clusters.reserve(master.size());
+        for (size_t i=0; i < state.labeledNodes; ++i){
+            Cluster cl(master[i]->id);
+            for (auto m : state.members[i]){
+                cl.members.push_back(master.at(m));
+            }
+            generateInputSet(cl);
+            res.clusters.push_back(cl);
+        }
+    }
+}
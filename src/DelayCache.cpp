@@ -0,0 +1,164 @@
+//
+// Persistent delay matrix cache (--delay_cache): built once per netlist, memory mapped by later runs
+//
+
+#include "../include/DelayCache.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define DELAY_CACHE_MAGIC "RWDC"
+#define DELAY_CACHE_VERSION 1
+#define DELAY_CACHE_PAYLOAD 4096 //the matrix starts on a page boundary of the mapping
+
+//native byte order: a cache is only read back on the machine (or kind of machine) that wrote it
+struct DelayCacheHeader {
+    char magic[4];
+    int32_t version;
+    DelayCacheKey key;
+    int32_t width;
+    int32_t unitDelay;
+    int32_t positiveDelay;
+    uint64_t payloadBytes;   //dense: N * N * width; sparse: offsets, sizes and values (SparseMatrix::save)
+    uint64_t valueCount;     //sparse: values stored in the row ranges
+};
+
+static const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+static uint64_t hashBytes(uint64_t hash, const char* bytes, size_t count){
+    for (size_t i=0; i < count; ++i){
+        hash = (hash ^ (unsigned char) bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+bool makeDelayCacheKey(std::string blifFile, std::vector<Node*>& master, int N, int piDelay, int poDelay,
+                       int nodeDelay, int mode, DelayCacheKey& key){
+    std::ifstream in(blifFile, std::ios::binary);
+    if (!in.is_open()) return false;
+    memset(&key, 0, sizeof(key));
+    key.netlistHash = FNV_OFFSET;
+    char buffer[1 << 16];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0){
+        key.netlistHash = hashBytes(key.netlistHash, buffer, in.gcount());
+    }
+    key.orderHash = FNV_OFFSET;
+    for (auto n : master){
+        key.orderHash = hashBytes(key.orderHash, n->strID.c_str(), n->strID.size() + 1);
+        key.orderHash = hashBytes(key.orderHash, (const char*) &n->delay, sizeof(n->delay));
+    }
+    key.piDelay = piDelay;
+    key.poDelay = poDelay;
+    key.nodeDelay = nodeDelay;
+    key.mode = mode;
+    key.N = N;
+    return true;
+}
+
+//why a cache of key cached cannot stand in for key, or "" if it can
+static std::string staleReason(const DelayCacheKey& cached, const DelayCacheKey& key){
+    if (cached.netlistHash != key.netlistHash) return "the netlist changed";
+    if (cached.piDelay != key.piDelay || cached.poDelay != key.poDelay || cached.nodeDelay != key.nodeDelay){
+        return "built with different -i/-o/-n values";
+    }
+    if (cached.mode != key.mode) return (cached.mode == DELAY_DENSE) ? "holds a dense matrix" : "holds a sparse matrix";
+    if (cached.N != key.N || cached.orderHash != key.orderHash) return "built for a different topological order";
+    return "";
+}
+
+int loadDelayCache(std::string filename, const DelayCacheKey& key, DelayData& dd, std::string& reason){
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return DELAY_CACHE_MISSING;
+    struct stat st;
+    DelayCacheHeader header;
+    if (fstat(fd, &st) != 0 || read(fd, &header, sizeof(header)) != (ssize_t) sizeof(header) ||
+        memcmp(header.magic, DELAY_CACHE_MAGIC, 4) != 0 || header.version != DELAY_CACHE_VERSION){
+        close(fd);
+        reason = "not a delay cache of this version";
+        return DELAY_CACHE_INVALID;
+    }
+    reason = staleReason(header.key, key);
+    if (reason != ""){
+        close(fd);
+        return DELAY_CACHE_STALE;
+    }
+    uint64_t expected = (key.mode == DELAY_DENSE) ? (uint64_t) key.N * key.N * header.width :
+                        (2 * (uint64_t) key.N + header.valueCount) * sizeof(int);
+    bool validWidth = (header.width == 1 || header.width == 2 || header.width == (int) sizeof(int));
+    if (!validWidth || header.payloadBytes != expected || (uint64_t) st.st_size != DELAY_CACHE_PAYLOAD + expected){
+        close(fd);
+        reason = "truncated";
+        return DELAY_CACHE_INVALID;
+    }
+    size_t length = st.st_size;
+    void* base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED){
+        reason = "cannot be mapped";
+        return DELAY_CACHE_INVALID;
+    }
+    dd.release();
+    dd.N = key.N;
+    dd.width = header.width;
+    dd.unitDelay = header.unitDelay;
+    dd.positiveDelay = header.positiveDelay;
+    dd.mapped = base;
+    dd.mappedBytes = length;
+    const char* payload = (const char*) base + DELAY_CACHE_PAYLOAD;
+    if (key.mode == DELAY_DENSE){
+        dd.dense = (void*) payload;
+    }
+    else {
+        const int* offsets = (const int*) payload;
+        dd.sparse = new SparseMatrix(key.N, key.N);
+        if (!dd.sparse->attachRows(offsets, offsets + key.N, offsets + 2 * key.N, header.valueCount)){
+            dd.release();
+            reason = "holds invalid row ranges";
+            return DELAY_CACHE_INVALID;
+        }
+    }
+    dd.mode = key.mode;
+    return DELAY_CACHE_LOADED;
+}
+
+bool writeDelayCache(std::string filename, const DelayCacheKey& key, DelayData& dd){
+    if (dd.mode != key.mode || (dd.mode != DELAY_DENSE && dd.mode != DELAY_SPARSE)) return false;
+    DelayCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DELAY_CACHE_MAGIC, 4);
+    header.version = DELAY_CACHE_VERSION;
+    header.key = key;
+    header.width = dd.width;
+    header.unitDelay = dd.unitDelay;
+    header.positiveDelay = dd.positiveDelay;
+    if (dd.mode == DELAY_DENSE){
+        header.payloadBytes = dd.bytes();
+    }
+    else {
+        header.valueCount = dd.sparse->storedEntries();
+        header.payloadBytes = (2 * (uint64_t) dd.N + header.valueCount) * sizeof(int);
+    }
+    std::string tmpName = filename + ".tmp" + std::to_string(getpid());
+    std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    static const char zeros[DELAY_CACHE_PAYLOAD] = {0};
+    out.write((const char*) &header, sizeof(header));
+    out.write(zeros, DELAY_CACHE_PAYLOAD - sizeof(header));
+    if (dd.mode == DELAY_DENSE){
+        out.write((const char*) dd.dense, header.payloadBytes);
+    }
+    else {
+        dd.sparse->save(out);
+    }
+    out.close();
+    if (!out || std::rename(tmpName.c_str(), filename.c_str()) != 0){
+        std::remove(tmpName.c_str());
+        return false;
+    }
+    return true;
+}
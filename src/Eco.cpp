@@ -0,0 +1,464 @@
+//
+// ECO mode: incremental re-labeling after small netlist edits
+//
+
+#include "../include/Eco.h"
+#include "../include/common.h"
+#include "../include/Progress.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#define ECO_MAGIC "RWCS"
+#define ECO_VERSION 2
+
+static void writeInt(std::ofstream& out, int32_t value){
+    out.write((const char*) &value, sizeof(value));
+}
+
+static int32_t readInt(std::ifstream& in){
+    int32_t value = 0;
+    in.read((char*) &value, sizeof(value));
+    return value;
+}
+
+bool saveEcoState(std::string filename, std::vector<Node*>& master, std::vector<Node*>& POs,
+                  LabelingResult& res, LabelingOptions& opts, int piDelay, int poDelay, int nodeDelay){
+    //Description: stores the graph, labels and clusters of an RW run so a later --eco run can reuse them
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    out.write(ECO_MAGIC, 4);
+    writeInt(out, ECO_VERSION);
+    writeInt(out, opts.maxClusterSize);
+    writeInt(out, opts.interClusterDelay);
+    writeInt(out, piDelay);
+    writeInt(out, poDelay);
+    writeInt(out, nodeDelay);
+    writeInt(out, master.size());
+    for (auto n : master){
+        writeInt(out, n->strID.length());
+        out.write(n->strID.data(), n->strID.length());
+        writeInt(out, n->delay);
+        Cluster& cl = res.clusters.at(n->id);
+        writeInt(out, (n->isPI ? 1 : 0) | (n->isPO ? 2 : 0) | (cl.tieFree ? 4 : 0));
+        writeInt(out, res.labels[n->id]);
+        writeInt(out, n->prev.size());
+        for (auto p : n->prev){
+            writeInt(out, p->id);
+        }
+        writeInt(out, cl.members.size());
+        for (auto mem : cl.members){
+            writeInt(out, mem->id);
+        }
+        writeInt(out, cl.inputSet.size());
+        for (auto in : cl.inputSet){
+            writeInt(out, in->id);
+        }
+    }
+    writeInt(out, POs.size());
+    for (auto po : POs){
+        writeInt(out, po->id);
+    }
+    out.close();
+    if (!out) return false;
+    return true;
+}
+
+//reads count indices that must all be below limit
+static bool readIndices(std::ifstream& in, std::vector<uint32_t>& indices, int count, int limit, long long fileSize){
+    if (!in || count < 0 || (long long) count * 4 > fileSize) return false;
+    indices.resize(count);
+    for (auto& i : indices){
+        i = readInt(in);
+        if (i >= (uint32_t) limit) return false;
+    }
+    return (bool) in;
+}
+
+bool loadEcoState(std::string filename, EcoState& state){
+    //Description: every count is checked against the file size and every index against the node count,
+    //so a truncated or corrupt state file is rejected instead of read out of bounds
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) return false;
+    long long fileSize = in.tellg();
+    in.seekg(0);
+    char magic[4];
+    in.read(magic, 4);
+    if (!in || memcmp(magic, ECO_MAGIC, 4) != 0 || readInt(in) != ECO_VERSION) return false;
+    state.maxClusterSize = readInt(in);
+    state.interClusterDelay = readInt(in);
+    state.piDelay = readInt(in);
+    state.poDelay = readInt(in);
+    state.nodeDelay = readInt(in);
+    int count = readInt(in);
+    //every node takes at least 7 ints
+    if (!in || count < 0 || (long long) count * 28 > fileSize) return false;
+    state.nodes.resize(count);
+    for (auto& n : state.nodes){
+        int len = readInt(in);
+        if (!in || len < 0 || len > fileSize) return false;
+        n.name.resize(len);
+        in.read(&n.name[0], len);
+        n.delay = readInt(in);
+        int flags = readInt(in);
+        n.isPI = flags & 1;
+        n.isPO = flags & 2;
+        n.tieFree = flags & 4;
+        n.label = readInt(in);
+        if (!readIndices(in, n.fanins, readInt(in), count, fileSize)) return false;
+        if (!readIndices(in, n.members, readInt(in), count, fileSize)) return false;
+        if (!readIndices(in, n.inputs, readInt(in), count, fileSize)) return false;
+    }
+    return readIndices(in, state.poOrder, readInt(in), count, fileSize);
+}
+
+bool buildNetlistFromDiff(EcoState& state, std::string diffFile, int& piDelay, int& poDelay, int& nodeDelay,
+                          std::vector<Node>& rawNodeList, std::vector<Node*>& POs, std::string& error){
+    //Description: rebuilds the netlist of the saved run and applies a diff BLIF on top of it
+    //the diff may add .inputs/.outputs/.latch and add or replace .names gates (fan-ins of an existing gate are
+    //replaced); an existing gate named in .outputs becomes a PO, as if it had been declared one in the BLIF
+    std::ifstream diff(diffFile);
+    if (!diff.is_open()){
+        error = "cannot open " + diffFile;
+        return false;
+    }
+
+    std::unordered_map<std::string, uint32_t> index;
+    for (uint32_t i=0; i < state.nodes.size(); ++i){
+        index[state.nodes[i].name] = i;
+    }
+    std::vector<EcoNode> added;
+    std::unordered_map<uint32_t, std::vector<std::string>> replaced; //fan-in names of new and replaced gates
+    bool outputsMode = false;
+    std::vector<uint32_t> newPOs;    //new outputs, in the order they are declared
+    std::vector<uint32_t> newLatches;
+    auto addNode = [&](std::string name, int delay, bool isPI, bool isPO) -> uint32_t {
+        auto it = index.find(name);
+        if (it != index.end()) return it->second;
+        EcoNode n;
+        n.name = name;
+        n.delay = delay;
+        n.isPI = isPI;
+        n.isPO = isPO;
+        n.tieFree = false;
+        n.label = 0;
+        uint32_t id = state.nodes.size() + added.size();
+        added.push_back(n);
+        index[name] = id;
+        if (isPO) (outputsMode ? newPOs : newLatches).push_back(id);
+        return id;
+    };
+    auto node = [&](uint32_t id) -> EcoNode& {
+        return (id < state.nodes.size()) ? state.nodes[id] : added[id - state.nodes.size()];
+    };
+
+    std::vector<uint32_t> promoted; //saved gates that became POs
+    std::string line;
+    std::string modeStr = "";
+    while (std::getline(diff, line)){
+        std::vector<std::string> signals = strSplitter(line);
+        if (signals.empty() || signals.at(0) == "") continue;
+        bool inputs = (signals.at(0) == ".inputs" || modeStr == ".inputs");
+        bool outputs = (signals.at(0) == ".outputs" || modeStr == ".outputs");
+        if (inputs || outputs){
+            auto iS = (modeStr == "") ? signals.begin()+1 : signals.begin();
+            modeStr = "";
+            for (; iS < signals.end(); ++iS){
+                if ((*iS).c_str()[0] == '\\') {
+                    modeStr = inputs ? ".inputs" : ".outputs";
+                    continue;
+                }
+                outputsMode = outputs;
+                uint32_t id = addNode(*iS, inputs ? piDelay : poDelay, inputs, outputs);
+                EcoNode& n = node(id);
+                if (inputs && !n.isPI){
+                    error = "input " + *iS + " is already a gate";
+                    return false;
+                }
+                if (outputs && n.isPI){
+                    error = "output " + *iS + " is already an input";
+                    return false;
+                }
+                if (outputs && !n.isPO){
+                    if (id < state.nodes.size()){
+                        if (std::find(promoted.begin(), promoted.end(), id) != promoted.end()) continue;
+                        promoted.push_back(id);
+                        newPOs.push_back(id);
+                    }
+                    else {
+                        n.isPO = true;
+                        n.delay = poDelay;
+                        newPOs.push_back(id);
+                    }
+                }
+            }
+            continue;
+        }
+        modeStr = "";
+        if (signals.at(0) == ".latch"){
+            //like parseBLIF: the latch input becomes a PO, its output a PI
+            if (signals.size() < 3){
+                error = "malformed .latch: " + line;
+                return false;
+            }
+            outputsMode = false;
+            uint32_t id = addNode(signals.at(1) + OUTPUT_LATCH_PREFIX, poDelay, false, true);
+            replaced[id] = std::vector<std::string>(1, signals.at(1));
+            addNode(signals.at(2) + INPUT_LATCH_PREFIX, piDelay, true, false);
+        }
+        else if (signals.at(0) == ".names"){
+            uint32_t id = addNode(signals.at(signals.size()-1), nodeDelay, false, false);
+            if (node(id).isPI){
+                error = "gate " + signals.at(signals.size()-1) + " is already an input";
+                return false;
+            }
+            replaced[id].assign(signals.begin()+1, signals.end()-1);
+        }
+    }
+
+    //no pointers are taken until the node list is complete
+    rawNodeList.clear();
+    rawNodeList.reserve(state.nodes.size() + added.size());
+    for (uint32_t i=0; i < state.nodes.size() + added.size(); ++i){
+        EcoNode& en = node(i);
+        Node n(en.delay);
+        n.strID = en.name;
+        n.isPI = en.isPI;
+        n.isPO = en.isPO;
+        rawNodeList.push_back(n);
+    }
+    for (auto p : promoted){
+        rawNodeList[p].isPO = true;
+        rawNodeList[p].delay = poDelay;
+    }
+    for (uint32_t i=0; i < rawNodeList.size(); ++i){
+        Node *n = &rawNodeList[i];
+        n->addr = n;
+        auto r = replaced.find(i);
+        if (r == replaced.end()){
+            for (auto f : state.nodes[i].fanins){
+                n->prev.push_back(&rawNodeList[f]);
+                rawNodeList[f].next.push_back(n);
+            }
+            continue;
+        }
+        for (auto& f : r->second){
+            auto it = index.find(f);
+            if (it == index.end()) it = index.find(f + INPUT_LATCH_PREFIX);
+            if (it == index.end()){
+                error = "gate driver not found: " + f;
+                return false;
+            }
+            Node *driver = &rawNodeList[it->second];
+            n->prev.push_back(driver);
+            driver->next.push_back(n);
+        }
+    }
+    state.match.resize(rawNodeList.size());
+    for (uint32_t i=0; i < rawNodeList.size(); ++i){
+        state.match[i] = (i < state.nodes.size()) ? (int32_t) i : -1;
+    }
+    //the PO order of a BLIF with the new outputs appended to .outputs (before the latch POs) and the new
+    //latches appended to the others
+    POs.clear();
+    size_t latchesFrom = 0;
+    for (size_t i=0; i < state.poOrder.size(); ++i){
+        const std::string& name = state.nodes[state.poOrder[i]].name;
+        bool latch = name.length() >= OUTPUT_LATCH_PREFIX.length() &&
+                     name.compare(name.length() - OUTPUT_LATCH_PREFIX.length(), OUTPUT_LATCH_PREFIX.length(), OUTPUT_LATCH_PREFIX) == 0;
+        if (!latch) latchesFrom = i + 1;
+    }
+    for (size_t i=0; i < state.poOrder.size(); ++i){
+        if (i == latchesFrom){
+            for (auto p : newPOs) POs.push_back(&rawNodeList[p]);
+        }
+        POs.push_back(&rawNodeList[state.poOrder[i]]);
+    }
+    if (latchesFrom == state.poOrder.size()){
+        for (auto p : newPOs) POs.push_back(&rawNodeList[p]);
+    }
+    for (auto p : newLatches){
+        POs.push_back(&rawNodeList[p]);
+    }
+    return true;
+}
+
+void matchEcoNodes(EcoState& state, std::vector<Node>& rawNodeList){
+    std::unordered_map<std::string, int32_t> oldIndex;
+    oldIndex.reserve(state.nodes.size());
+    for (uint32_t i=0; i < state.nodes.size(); ++i){
+        oldIndex[state.nodes[i].name] = i;
+    }
+    state.match.assign(rawNodeList.size(), -1);
+    for (uint32_t i=0; i < rawNodeList.size(); ++i){
+        auto it = oldIndex.find(rawNodeList[i].strID);
+        if (it != oldIndex.end()) state.match[i] = it->second;
+    }
+}
+
+//Ties between equal label_v values are broken by topological position, so a saved cluster can only
+//change if two nodes of the cone are in the opposite order from the saved run. The matched nodes are cut
+//into runs whose saved positions follow each other (among the matched nodes); consecutive runs are put
+//into at most 64 groups. inverted[g] holds every group with a node pair in the opposite order to one in
+//g, including g itself if it has one inside.
+struct OrderGroups {
+    std::vector<int8_t> group;  //by id, -1 for added nodes
+    uint64_t inverted[64];
+    uint64_t any = 0;           //groups with any inverted pair
+
+    OrderGroups(std::vector<Node*>& master, std::vector<int32_t>& oldIndex, size_t oldCount){
+        std::vector<int32_t> compact(oldCount, -1);
+        for (auto v : master){
+            if (oldIndex[v->id] >= 0) compact[oldIndex[v->id]] = 0;
+        }
+        int32_t matched = 0;
+        for (auto& c : compact){
+            if (c == 0) c = matched++;
+        }
+        size_t runs = 0;
+        int32_t last = -2;
+        for (auto v : master){
+            if (oldIndex[v->id] < 0) continue;
+            int32_t c = compact[oldIndex[v->id]];
+            runs += (c != last + 1);
+            last = c;
+        }
+        std::vector<int32_t> lo(64, matched);
+        std::vector<int32_t> hi(64, -1);
+        uint64_t inside = 0;
+        group.assign(master.size(), -1);
+        size_t run = 0;
+        last = -2;
+        for (auto v : master){
+            if (oldIndex[v->id] < 0) continue;
+            int32_t c = compact[oldIndex[v->id]];
+            run += (c != last + 1);
+            last = c;
+            int g = (int) ((run - 1) * 64 / runs);
+            if (hi[g] > c) inside |= 1ULL << g;  //an earlier node of g came later in the saved run
+            lo[g] = std::min(lo[g], c);
+            hi[g] = std::max(hi[g], c);
+            group[v->id] = g;
+        }
+        for (int i=0; i < 64; ++i){
+            inverted[i] = inside & (1ULL << i);
+            for (int j=0; j < 64; ++j){
+                //every node of the earlier group comes first in the new order
+                if ((i < j && hi[i] > lo[j]) || (j < i && hi[j] > lo[i])) inverted[i] |= 1ULL << j;
+            }
+            if (inverted[i]) any |= 1ULL << i;
+        }
+    }
+
+    //true if two groups of a cone (or one group twice) hold a pair of nodes in the opposite order
+    bool reordered(uint64_t coneGroups){
+        if ((coneGroups & any) == 0) return false;
+        for (int i=0; i < 64; ++i){
+            if ((coneGroups >> i & 1) && (inverted[i] & coneGroups)) return true;
+        }
+        return false;
+    }
+};
+
+void computeLabelsIncremental(std::vector<Node*>& master, std::vector<Node>& rawNodeList, EcoState& state,
+                              LabelingOptions& opts, LabelingResult& res, EcoStats& stats){
+    //Description: RW labeling that only relabels nodes whose fan-in cone differs from the saved run
+    //label(v) depends on every label and delay in v's fan-in cone, so a changed node dirties its whole
+    //transitive fan-out even when its own label comes out the same. Ties between equal label_v values are
+    //broken by the topological position, so a node whose cone holds two nodes that swapped places is
+    //relabeled as well unless its saved cluster was picked without ties; that only dirties its fan-out if
+    //its label changed. Relabeled nodes get their
+    //delays from their own cone, so no delay matrix is built
+    std::vector<int>& labels = res.labels;
+    std::vector<int32_t> oldIndex(labels.size(), -1);
+    std::vector<Node*> newNodes(state.nodes.size(), nullptr);
+    for (auto v : master){
+        int32_t o = state.match.at(v - rawNodeList.data());
+        oldIndex[v->id] = o;
+        if (o >= 0) newNodes[o] = v;
+    }
+    OrderGroups order(master, oldIndex, state.nodes.size());
+
+    DelayData coneDelays;
+    prepareDelays(master, labels.size(), DELAY_CONE, coneDelays);
+    LabelScratch scratch;
+    scratch.resize(labels.size());
+    std::vector<char> dirty(labels.size(), false);     //the cone or a label in it differs from the saved run
+    std::vector<uint64_t> coneGroups(labels.size(), 0); //order groups of the nodes in the cone
+    res.clusters.clear();
+    res.clusters.reserve(master.size());
+    res.maxLabel = 0;
+    res.maxIODelay = 0;
+    res.labeledNodes = 0;
+    res.interrupted = false;
+
+    ProgressMeter progress("eco labeling", "nodes", master.size());
+    for (auto v : master){
+        if (interruptRequested()) break;
+        progress.update(res.labeledNodes);
+        int32_t o = oldIndex[v->id];
+        //the PO role and the logic function of a gate do not take part in labeling
+        bool changed = (o < 0);
+        if (!changed){
+            EcoNode& old = state.nodes[o];
+            changed = old.delay != v->delay || old.isPI != v->isPI || old.fanins.size() != v->prev.size();
+            for (size_t i=0; !changed && i < v->prev.size(); ++i){
+                //fan-ins in the same order, so the input sets of the saved clusters stay valid too
+                changed = (oldIndex[v->prev[i]->id] != (int32_t) old.fanins[i]);
+            }
+        }
+        bool isDirty = changed;
+        uint64_t groups = 0;
+        for (auto p : v->prev){
+            isDirty = isDirty || dirty[p->id];
+            groups |= coneGroups[p->id] | ((order.group[p->id] >= 0) ? 1ULL << order.group[p->id] : 0);
+        }
+        bool isReordered = !isDirty && order.reordered(groups);
+        stats.changed += changed;
+
+        Cluster cl(v->id);
+        bool reuse = !isDirty && (!isReordered || state.nodes[o].tieFree);
+        if (reuse){
+            EcoNode& old = state.nodes[o];
+            labels[v->id] = old.label;
+            cl.tieFree = old.tieFree;
+            for (auto m : old.members){
+                cl.members.push_back(newNodes[m]);
+            }
+            for (auto in : old.inputs){
+                cl.inputSet.push_back(newNodes[in]);
+            }
+            //members and inputs lie in the unchanged cone; anything else means the state does not fit
+            reuse = std::find(cl.members.begin(), cl.members.end(), nullptr) == cl.members.end() &&
+                    std::find(cl.inputSet.begin(), cl.inputSet.end(), nullptr) == cl.inputSet.end();
+            if (!reuse){
+                cl = Cluster(v->id);
+                isDirty = true;
+            }
+        }
+        if (reuse){
+            stats.reused += 1;
+        }
+        else {
+            stats.dirty += 1;
+            labelNodeRW(v, master, coneDelays, opts, labels, scratch, cl);
+            if (!isDirty){
+                stats.reordered += 1;
+                isDirty = (labels[v->id] != state.nodes[o].label);
+            }
+        }
+        dirty[v->id] = isDirty;
+        coneGroups[v->id] = groups;
+        res.maxLabel = (labels[v->id] > res.maxLabel) ? labels[v->id] : res.maxLabel;
+        res.clusters.push_back(cl);
+        ++res.labeledNodes;
+    }
+    progress.finish(res.labeledNodes);
+    if (res.labeledNodes < master.size()){
+        res.interrupted = true;
+        for (size_t i = res.clusters.size(); i < master.size(); ++i){
+            res.clusters.push_back(Cluster(master[i]->id));
+        }
+    }
+}
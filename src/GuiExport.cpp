@@ -0,0 +1,313 @@
+//
+// Level-of-detail GUI export: views of a binary result file (.rwb) small enough for the Python GUI
+//
+
+#include "../include/GuiExport.h"
+#include <algorithm>
+#include <fstream>
+
+#define GUI_NO_VERTEX 0xffffffffu
+//above this many clusters the L set after every step is left out, it grows quadratically with the view
+#define GUI_LSET_HISTORY_LIMIT 256
+
+//Maps nodes of the result file to vertices of one granularity
+struct GuiIndex {
+    int granularity;
+    uint64_t count;
+    std::vector<uint32_t> owner;                  //vertex of every node (cluster and level granularities)
+    std::vector<std::vector<uint32_t>> levelPrev; //fan-in levels of every level
+    std::vector<int> levelDelay;
+    std::vector<int> levelLabel;
+    std::vector<int> levelSize;
+};
+
+static void buildGuiIndex(const ResultFileReader& rf, int granularity, GuiIndex& idx){
+    idx.granularity = granularity;
+    uint64_t N = rf.nodeCount();
+    if (granularity == GUI_VIEW_NODES){
+        idx.count = N;
+    }
+    else if (granularity == GUI_VIEW_CLUSTERS){
+        //a node belongs to the final cluster rooted at it, otherwise to the first final cluster that holds it
+        idx.count = rf.finalCount();
+        idx.owner.assign(N, GUI_NO_VERTEX);
+        for (uint64_t f=0; f < rf.finalCount(); ++f){
+            idx.owner[rf.finalCluster(f).rootId] = f;
+        }
+        for (uint64_t f=0; f < rf.finalCount(); ++f){
+            const RWBCluster& c = rf.finalCluster(f);
+            const uint32_t *mem = rf.members(c);
+            for (uint32_t m=0; m < c.memberCount; ++m){
+                if (idx.owner[mem[m]] == GUI_NO_VERTEX) idx.owner[mem[m]] = f;
+            }
+        }
+    }
+    else {
+        //node ids are topological, so every fan-in has its level before the node is reached
+        idx.owner.assign(N, 0);
+        uint32_t maxLevel = 0;
+        for (uint64_t i=0; i < N; ++i){
+            const uint32_t *fi = rf.fanins(i);
+            uint32_t level = 0;
+            for (uint64_t k=0; k < rf.faninCount(i); ++k){
+                level = std::max(level, idx.owner[fi[k]] + 1);
+            }
+            idx.owner[i] = level;
+            maxLevel = std::max(maxLevel, level);
+        }
+        idx.count = (N > 0) ? maxLevel + 1 : 0;
+        idx.levelPrev.assign(idx.count, std::vector<uint32_t>());
+        idx.levelDelay.assign(idx.count, 0);
+        idx.levelLabel.assign(idx.count, 0);
+        idx.levelSize.assign(idx.count, 0);
+        for (uint64_t i=0; i < N; ++i){
+            uint32_t level = idx.owner[i];
+            const RWBNode& n = rf.node(i);
+            idx.levelDelay[level] = std::max(idx.levelDelay[level], n.delay);
+            idx.levelLabel[level] = std::max(idx.levelLabel[level], n.label);
+            idx.levelSize[level] += 1;
+            const uint32_t *fi = rf.fanins(i);
+            for (uint64_t k=0; k < rf.faninCount(i); ++k){
+                idx.levelPrev[level].push_back(idx.owner[fi[k]]);
+            }
+        }
+        for (auto& prev : idx.levelPrev){
+            std::sort(prev.begin(), prev.end());
+            prev.erase(std::unique(prev.begin(), prev.end()), prev.end());
+        }
+    }
+}
+
+static void vertexFanins(const ResultFileReader& rf, const GuiIndex& idx, uint32_t v, std::vector<uint32_t>& out){
+    out.clear();
+    if (idx.granularity == GUI_VIEW_NODES){
+        out.assign(rf.fanins(v), rf.fanins(v) + rf.faninCount(v));
+    }
+    else if (idx.granularity == GUI_VIEW_CLUSTERS){
+        const RWBCluster& c = rf.finalCluster(v);
+        const uint32_t *in = rf.inputs(c);
+        for (uint32_t k=0; k < c.inputCount; ++k){
+            uint32_t u = idx.owner[in[k]];
+            if (u != GUI_NO_VERTEX && u != v) out.push_back(u);
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+    else {
+        out = idx.levelPrev[v];
+    }
+}
+
+static uint32_t vertexOfNode(const GuiIndex& idx, uint32_t node){
+    return (idx.granularity == GUI_VIEW_NODES) ? node : idx.owner[node];
+}
+
+bool selectGuiVertices(const ResultFileReader& rf, int granularity, const std::vector<std::string>& seeds,
+                       int depth, std::vector<uint32_t>& selected, std::string& error){
+    //Description: breadth-first walk over the fan-ins of the seed vertices, one layer per unit of depth
+    if (!rf.hasGraph()){
+        error = "result file version " + std::to_string(rf.header().version) + " has no fan-in section, write it again with rw --binary";
+        return false;
+    }
+    GuiIndex idx;
+    buildGuiIndex(rf, granularity, idx);
+    selected.clear();
+    if (seeds.empty()){
+        for (uint64_t v=0; v < idx.count; ++v){
+            selected.push_back(v);
+        }
+        return true;
+    }
+    std::vector<char> marked(idx.count, false);
+    std::vector<uint32_t> frontier;
+    for (auto& name : seeds){
+        uint32_t node;
+        if (!rf.findNode(name, node)){
+            error = "no node named " + name;
+            return false;
+        }
+        uint32_t v = vertexOfNode(idx, node);
+        if (v == GUI_NO_VERTEX){
+            error = name + " is not part of any final cluster";
+            return false;
+        }
+        if (!marked[v]){
+            marked[v] = true;
+            frontier.push_back(v);
+        }
+    }
+    selected = frontier;
+    std::vector<uint32_t> fanins;
+    for (int d=0; (depth < 0 || d < depth) && !frontier.empty(); ++d){
+        std::vector<uint32_t> nextFrontier;
+        for (auto v : frontier){
+            vertexFanins(rf, idx, v, fanins);
+            for (auto u : fanins){
+                if (marked[u]) continue;
+                marked[u] = true;
+                nextFrontier.push_back(u);
+                selected.push_back(u);
+            }
+        }
+        frontier.swap(nextFrontier);
+    }
+    std::sort(selected.begin(), selected.end());
+    return true;
+}
+
+void buildGuiView(const ResultFileReader& rf, int granularity, const std::vector<uint32_t>& selected, GuiView& view){
+    //Description: turns the selected vertices into GUI vertices numbered by their position in selected;
+    //edges, cluster members and input sets leaving the selection are dropped
+    GuiIndex idx;
+    buildGuiIndex(rf, granularity, idx);
+    view.granularity = granularity;
+    view.maxIODelay = rf.header().maxIODelay;
+    view.vertices.assign(selected.size(), GuiVertex());
+    view.clusters.clear();
+
+    std::vector<uint32_t> position(idx.count, GUI_NO_VERTEX);
+    for (uint32_t i=0; i < selected.size(); ++i){
+        position[selected[i]] = i;
+    }
+    auto inView = [&](const uint32_t *ids, uint64_t count, bool isNode, std::vector<uint32_t>& out){
+        for (uint64_t k=0; k < count; ++k){
+            uint32_t v = isNode ? vertexOfNode(idx, ids[k]) : ids[k];
+            if (v != GUI_NO_VERTEX && position[v] != GUI_NO_VERTEX) out.push_back(position[v]);
+        }
+    };
+
+    std::vector<uint32_t> fanins;
+    for (uint32_t i=0; i < selected.size(); ++i){
+        uint32_t v = selected[i];
+        GuiVertex& gv = view.vertices[i];
+        vertexFanins(rf, idx, v, fanins);
+        inView(fanins.data(), fanins.size(), false, gv.prev);
+        if (granularity == GUI_VIEW_NODES){
+            const RWBNode& n = rf.node(v);
+            gv.name = rf.nodeName(v);
+            gv.delay = n.delay;
+            gv.label = n.label;
+            if (!(rf.header().flags & RWB_FLAG_LAWLER)){
+                const RWBCluster& c = rf.cluster(v);
+                inView(rf.members(c), c.memberCount, true, gv.cluster);
+            }
+            else {
+                gv.cluster.push_back(i);
+            }
+        }
+        else if (granularity == GUI_VIEW_CLUSTERS){
+            const RWBCluster& c = rf.finalCluster(v);
+            const RWBNode& root = rf.node(c.rootId);
+            gv.name = rf.nodeName(c.rootId) + "[" + std::to_string(c.memberCount) + "]";
+            gv.delay = root.delay;
+            gv.label = root.label;
+            gv.cluster.push_back(i);
+        }
+        else {
+            gv.name = "level" + std::to_string(v) + "[" + std::to_string(idx.levelSize[v]) + "]";
+            gv.delay = idx.levelDelay[v];
+            gv.label = idx.levelLabel[v];
+            gv.cluster.push_back(i);
+        }
+    }
+    for (uint32_t i=0; i < view.vertices.size(); ++i){
+        for (auto p : view.vertices[i].prev){
+            view.vertices[p].next.push_back(i);
+        }
+    }
+
+    if (granularity == GUI_VIEW_NODES){
+        //final clusters in clustering order, as long as their root is shown
+        for (uint64_t f=0; f < rf.finalCount(); ++f){
+            const RWBCluster& c = rf.finalCluster(f);
+            if (position[c.rootId] == GUI_NO_VERTEX) continue;
+            GuiCluster gc;
+            gc.root = position[c.rootId];
+            gc.initial = rf.node(c.rootId).isPO || view.vertices[gc.root].next.empty();
+            inView(rf.members(c), c.memberCount, true, gc.members);
+            inView(rf.inputs(c), c.inputCount, true, gc.inputs);
+            view.clusters.push_back(gc);
+        }
+    }
+    else {
+        //aggregated vertices are their own clusters, fed by their fan-in vertices; the final clusters keep
+        //their clustering order, levels are visited from the outputs back like the RW clustering loop
+        for (uint32_t k=0; k < view.vertices.size(); ++k){
+            uint32_t i = (granularity == GUI_VIEW_LEVELS) ? view.vertices.size()-1 - k : k;
+            GuiCluster gc;
+            gc.root = i;
+            gc.initial = view.vertices[i].next.empty();
+            gc.members.push_back(i);
+            gc.inputs = view.vertices[i].prev;
+            view.clusters.push_back(gc);
+        }
+    }
+}
+
+static void writeIdList(std::ofstream& out, const std::vector<uint32_t>& ids){
+    for (size_t k=0; k < ids.size(); ++k){
+        out << ids[k] + 1;
+        if (k+1 < ids.size()) out << " ";
+    }
+}
+
+static void writeLSet(std::ofstream& out, const GuiView& view, const std::vector<int>& queuedAt, size_t step){
+    //L after step clusters: every later cluster whose root was already queued
+    bool first = true;
+    for (size_t k=step; k < view.clusters.size(); ++k){
+        if (queuedAt[k] > (int) step) continue;
+        if (!first) out << " ";
+        out << view.clusters[k].root + 1;
+        first = false;
+    }
+}
+
+bool writeGuiView(const GuiView& view, std::string filename){
+    //Description: same layout as writeGUIFile; the L set history is not stored in the result file, so it is
+    //replayed from the cluster order: a cluster is queued by the first earlier cluster that has its root as input
+    std::ofstream guiFile(filename, std::ios::trunc);
+    if (!guiFile.is_open()) return false;
+    guiFile << "//NODES" << std::endl;
+    for (uint32_t i=0; i < view.vertices.size(); ++i){
+        const GuiVertex& gv = view.vertices[i];
+        guiFile << i + 1 << ":" << gv.name << ";" << gv.delay << ";";
+        writeIdList(guiFile, gv.prev);
+        guiFile << ";";
+        writeIdList(guiFile, gv.next);
+        guiFile << ";" << gv.label << ";";
+        writeIdList(guiFile, gv.cluster);
+        guiFile << std::endl;
+    }
+    guiFile << "//CLUSTERS" << std::endl;
+    bool history = view.clusters.size() <= GUI_LSET_HISTORY_LIMIT;
+    std::vector<int> queuedAt(view.clusters.size(), view.clusters.size());
+    if (history){
+        std::vector<int> stepOfRoot(view.vertices.size(), -1);
+        for (size_t k=0; k < view.clusters.size(); ++k){
+            stepOfRoot[view.clusters[k].root] = k;
+            if (view.clusters[k].initial) queuedAt[k] = 0;
+        }
+        for (size_t k=0; k < view.clusters.size(); ++k){
+            for (auto in : view.clusters[k].inputs){
+                int j = stepOfRoot[in];
+                if (j > (int) k && queuedAt[j] > (int) k+1) queuedAt[j] = k+1;
+            }
+        }
+    }
+    guiFile << "LSET:";
+    if (history) writeLSet(guiFile, view, queuedAt, 0);
+    guiFile << std::endl;
+    for (size_t k=0; k < view.clusters.size(); ++k){
+        const GuiCluster& gc = view.clusters[k];
+        guiFile << gc.root + 1 << ":";
+        writeIdList(guiFile, gc.members);
+        guiFile << ";LSET:";
+        if (history) writeLSet(guiFile, view, queuedAt, k+1);
+        guiFile << ";ISET:";
+        writeIdList(guiFile, gc.inputs);
+        guiFile << std::endl;
+    }
+    guiFile << "//MAXDELAY" << std::endl;
+    guiFile << view.maxIODelay;
+    return true;
+}
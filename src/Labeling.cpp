@@ -0,0 +1,1025 @@
+//
+// Labeling and clustering phases of the RW/Lawler clustering application
+//
+
+#include "../include/Labeling.h"
+#include "../include/DelayProvider.h"
+#include "../include/common.h"
+#include "../include/Metrics.h"
+#include "../include/Trace.h"
+#include "../include/TaskPool.h"
+#include "../include/Progress.h"
+#include "../include/LargeAlloc.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <sys/mman.h>
+
+#define PARALLEL_GRAIN 4096 //S entries per stealable chunk of a giant cone
+#define CHECKPOINT_STRIDE 256 //labeled nodes between two looks at the checkpoint clock
+#define DELAY_ROW_GRAIN 16 //delay matrix rows per stealable chunk
+
+DelayData::DelayData(){
+    mode = DELAY_NONE;
+    N = 0;
+    width = sizeof(int);
+    unitDelay = false;
+    positiveDelay = false;
+    dense = nullptr;
+    denseBytes = 0;
+    sparse = nullptr;
+    mapped = nullptr;
+    mappedBytes = 0;
+}
+
+DelayData::~DelayData(){
+    release();
+}
+
+void DelayData::release(){
+    if (mapped == nullptr) releaseLarge(dense, denseBytes);
+    delete sparse;
+    if (mapped != nullptr) munmap(mapped, mappedBytes);
+    dense = nullptr;
+    denseBytes = 0;
+    mapped = nullptr;
+    mappedBytes = 0;
+    sparse = nullptr;
+    mode = DELAY_NONE;
+}
+
+void DelayData::allocateDense(){
+    denseBytes = (size_t) N * N * width;
+    dense = allocateLarge(denseBytes);
+}
+
+long long DelayData::bytes() const{
+    if (mode == DELAY_DENSE) return (long long) N * N * width;
+    if (mode == DELAY_SPARSE) return sparse->bytes();
+    return 0;
+}
+
+//adds a node and its predecessors to vector in topological order
+void addPredecessors(std::vector<Node *> &m, Node *n){
+    if(n->visited) return;
+    for(auto node : n->prev){
+        if (!node->visited) addPredecessors(m, node);
+    }
+    n->visited = true; //todo: remove the need for a visited flag by using a more efficient method
+    m.push_back(n);
+    //std::cout << "Adding " << n->strID  << " to master." << std::endl; //debug
+}
+
+//same as addPredecessors, but keeps the visited flags in a per-run array (indexed by node id)
+//so that several runs can walk the same graph at once
+void collectPredecessors(std::vector<Node *> &m, Node *n, std::vector<char> &visited){
+    if(visited[n->id]) return;
+    for(auto node : n->prev){
+        if (!visited[node->id]) collectPredecessors(m, node, visited);
+    }
+    visited[n->id] = true;
+    m.push_back(n);
+}
+
+//find longest path in the DAG using topological ordering properties
+//requirement: nodes must be topologically sorted with sequential IDs (starting at 0)
+template <bool UNIT>
+int maxDelayT(const Node* src, const Node* dst, const std::vector<Node *>& nodes){
+    metricsAdd(METRICS.maxDelayCalls, 1);
+    if(src->id >= dst->id) return 0; //no path between these nodes if src does not come before dst
+    int offset = src->id; //use offset to avoid making the delays array longer than necessary
+    int delays[dst->id - offset + 1]; //a delay value for all topological nodes between src and dst (inclusive)
+    for(int i=0; i<=(int) dst->id-offset; ++i){ //initialize delays vector to -1 for each node
+        delays[i] = -1;
+    }
+    //set delay of source to 0
+    delays[0] =  0;
+    for(int i=0; i<(int) dst->id-offset; ++i){
+        if(delays[i] != -1){
+            for(auto it = nodes[i+offset]->next.begin(); it != nodes[i+offset]->next.end(); ++it){
+                if((*it)->id <= dst->id) { //don't operate on nodes which come topologically after dst
+                    int d = delays[i] + (UNIT ? 1 : (*it)->delay);
+                    if(delays[(*it)->id - offset] < d){
+                        delays[(*it)->id - offset] = d;
+                    }
+                }
+            }
+        }
+    }
+    if(delays[dst->id - offset] == -1) return 0; //if there was no path from src to dst, return 0
+    return delays[dst->id - offset];
+}
+template int maxDelayT<true>(const Node*, const Node*, const std::vector<Node *>&);
+template int maxDelayT<false>(const Node*, const Node*, const std::vector<Node *>&);
+
+int max_delay(Node* src, Node* dst, const std::vector<Node *>& nodes){
+    return maxDelayT<false>(src, dst, nodes);
+}
+
+void analyzeDelays(std::vector<Node*>& master, DelayData& dd){
+    //Description: detects unit delays and the narrowest dense entry that holds every path delay
+    //longest[v] = longest path delay ending at v (including v), an upper bound for delay_matrix[x][v]
+    bool unit = true;
+    bool positive = true;
+    bool negative = false;
+    int maxPath = 0;
+    std::vector<int> longest(master.size(), 0);
+    for (auto v : master){
+        int best = 0;
+        for (auto p : v->prev){
+            best = (longest[p->id] > best) ? longest[p->id] : best;
+        }
+        if (!v->prev.empty() && v->delay != 1) unit = false;
+        if (!v->prev.empty() && v->delay <= 0) positive = false;
+        if (v->delay < 0) negative = true;
+        longest[v->id] = best + v->delay;
+        maxPath = (longest[v->id] > maxPath) ? longest[v->id] : maxPath;
+    }
+    dd.unitDelay = unit;
+    dd.positiveDelay = positive;
+    if (negative) dd.width = sizeof(int);
+    else if (maxPath <= UINT8_MAX) dd.width = 1;
+    else if (maxPath <= UINT16_MAX) dd.width = 2;
+    else dd.width = sizeof(int);
+}
+
+//Runs buildRow(ri) for every row position of a delay matrix, split over a task pool when threads > 1.
+//Only the calling thread reports progress; rows after a SIGINT are skipped (and stay zero)
+template <class RowBuilder>
+static void forEachMatrixRow(std::vector<Node*>& master, int threads, RowBuilder& buildRow){
+    //row ri fills the master.size()-1-ri entries after r, so the ETA counts entries rather than rows
+    uint64_t rows = master.size();
+    ProgressMeter progress("delay matrix", "rows", rows, rows * (rows - 1) / 2);
+    std::atomic<uint64_t> doneRows(0);
+    std::atomic<uint64_t> doneEntries(0);
+    std::thread::id caller = std::this_thread::get_id();
+    auto body = [&](size_t lo, size_t hi){
+        uint64_t entries = 0;
+        size_t ri = lo;
+        for (; ri < hi && !interruptRequested(); ++ri){
+            buildRow(ri);
+            entries += rows - 1 - ri;
+        }
+        uint64_t done = doneRows.fetch_add(ri - lo) + (ri - lo);
+        uint64_t work = doneEntries.fetch_add(entries) + entries;
+        if (std::this_thread::get_id() == caller) progress.update(done, work);
+    };
+    threads = labelThreadCount(threads);
+    if (threads > 1 && rows > DELAY_ROW_GRAIN){
+        TaskPool pool(threads);
+        pool.parallelFor(0, rows, DELAY_ROW_GRAIN, body);
+    }
+    else {
+        //one chunk per row, so progress and SIGINT are looked at as often as before
+        for (size_t ri = 0; ri < rows && !interruptRequested(); ++ri) body(ri, ri + 1);
+    }
+    progress.finish(doneRows.load());
+}
+
+//delay_matrix[r][c] = max( delay_matrix[r][c->prev] ) + delay(c), or delay(c) if r drives c directly
+//the matrix comes zeroed from allocateLarge, so only the entries after r are written; each row is first
+//touched by the thread that builds it
+template <typename T, bool UNIT>
+static void buildDenseMatrix(std::vector<Node*>& master, long long N, T* matrix, int threads){
+    auto buildRow = [&](size_t ri){
+        Node *r = master[ri];
+        T *row = matrix + N * r->id;
+        for (size_t ci = ri + 1; ci < master.size(); ++ci){
+            Node *c = master[ci];
+            int max = 0;
+            for (Node *p : c->prev){
+                int prev_delay = row[p->id];
+                max = (prev_delay > max) ? prev_delay : max;
+            }
+            int delay = UNIT ? 1 : c->delay;
+            if (max == 0){
+                //if no predecessors of c have a delay to r, then either r is a direct predecessor, or there is no link
+                T value = 0;
+                for (Node *p2 : c->prev){
+                    if (p2 == r) value = delay;
+                }
+                row[c->id] = value;
+            }
+            else {
+                row[c->id] = delay + max;
+            }
+        }
+    };
+    forEachMatrixRow(master, threads, buildRow);
+}
+
+//a sparse row is built in a full width scratch row and stored once, from the first nonzero delay to the last
+//column written after it (the range sequential insertion would give)
+struct SparseRowScratch {
+    std::vector<int> row;
+    SparseMatrix::RowPool pool;
+};
+
+template <bool UNIT>
+static void buildSparseMatrix(std::vector<Node*>& master, SparseMatrix* matrix, int threads){
+    std::mutex lock;
+    std::vector<std::unique_ptr<SparseRowScratch>> idle;
+    auto buildRow = [&](size_t ri){
+        std::unique_ptr<SparseRowScratch> scratch;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (!idle.empty()){
+                scratch = std::move(idle.back());
+                idle.pop_back();
+            }
+        }
+        if (!scratch){
+            scratch.reset(new SparseRowScratch());
+            scratch->row.assign(master.size(), 0);
+        }
+        std::vector<int>& row = scratch->row;
+        Node *r = master[ri];
+        int first = -1;
+        int last = -1;
+        for (size_t ci = ri + 1; ci < master.size(); ++ci){
+            Node *c = master[ci];
+            int max = 0;
+            for (Node *p : c->prev){
+                int prev_delay = row[p->id];
+                max = (prev_delay > max) ? prev_delay : max;
+            }
+            int delay = UNIT ? 1 : c->delay;
+            int value = delay + max;
+            if (max == 0){
+                bool direct = false;
+                for (Node *p2 : c->prev){
+                    if (p2 == r) direct = true;
+                }
+                if (!direct) continue;
+                value = delay;
+            }
+            if (first < 0){
+                if (value == 0) continue; //no need to store a 0
+                first = c->id;
+            }
+            row[c->id] = value;
+            last = c->id;
+        }
+        if (first >= 0){
+            int* stored = matrix->allocateRow(r->id, first, last - first + 1, scratch->pool);
+            std::copy(row.begin() + first, row.begin() + last + 1, stored);
+            std::fill(row.begin() + first, row.begin() + last + 1, 0);
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        idle.push_back(std::move(scratch));
+    };
+    forEachMatrixRow(master, threads, buildRow);
+}
+
+void computeDelayMatrix(std::vector<Node*>& master, int N, bool useSparse, DelayData& dd, int threads){
+    //////     COMPUTE DELAY MATRIX //////
+    // delay_matrix[x][y] = max delay from output x to output y (node delay only)
+    //delay_matrix[N*r+c] (aka delay_matrix[r][c]) represents max delay from node r to node c
+    //the matrix entry = 0 if c precedes r in topological order
+    dd.release();
+    analyzeDelays(master, dd);
+    dd.N = N;
+    if(useSparse) {
+        dd.mode = DELAY_SPARSE;
+        dd.sparse = new SparseMatrix(N,N);
+        if (dd.unitDelay) buildSparseMatrix<true>(master, dd.sparse, threads);
+        else buildSparseMatrix<false>(master, dd.sparse, threads);
+        return;
+    }
+    dd.mode = DELAY_DENSE;
+    dd.allocateDense(); // Delay matrix is NxN square matrix.
+    if (dd.width == 1) {
+        if (dd.unitDelay) buildDenseMatrix<uint8_t, true>(master, N, (uint8_t*) dd.dense, threads);
+        else buildDenseMatrix<uint8_t, false>(master, N, (uint8_t*) dd.dense, threads);
+    }
+    else if (dd.width == 2) {
+        if (dd.unitDelay) buildDenseMatrix<uint16_t, true>(master, N, (uint16_t*) dd.dense, threads);
+        else buildDenseMatrix<uint16_t, false>(master, N, (uint16_t*) dd.dense, threads);
+    }
+    else {
+        if (dd.unitDelay) buildDenseMatrix<int, true>(master, N, (int*) dd.dense, threads);
+        else buildDenseMatrix<int, false>(master, N, (int*) dd.dense, threads);
+    }
+}
+
+void prepareDelays(std::vector<Node*>& master, int N, int mode, DelayData& dd, int threads){
+    //Description: readies dd for labeling in the given mode; only the dense and sparse modes store anything
+    //DELAY_UNIT falls back to DELAY_CONE if the delays are not uniform
+    if (mode == DELAY_DENSE || mode == DELAY_SPARSE){
+        computeDelayMatrix(master, N, mode == DELAY_SPARSE, dd, threads);
+        return;
+    }
+    dd.release();
+    analyzeDelays(master, dd);
+    dd.mode = mode;
+    dd.N = N;
+    if (mode == DELAY_UNIT && !dd.unitDelay) dd.mode = DELAY_CONE;
+}
+
+//records the size of a finished delay matrix; walks the whole matrix so it is kept out of the timed phase
+void recordDelayMatrixMetrics(DelayData& dd){
+    if (!METRICS.enabled) return;
+    if (dd.mode == DELAY_SPARSE){
+        metricsAdd(METRICS.delayMatrixEntries, dd.sparse->storedEntries());
+        metricsAdd(METRICS.delayMatrixNonZeros, dd.sparse->nonZeros());
+        metricsAdd(METRICS.delayMatrixBytes, dd.sparse->bytes());
+    }
+    else if (dd.mode == DELAY_DENSE){
+        long long nonZeros = 0;
+        for (uint32_t r=0; r < (uint32_t) dd.N; ++r){
+            for (uint32_t c=0; c < (uint32_t) dd.N; ++c){
+                if (dd.get(r, c) != 0) ++nonZeros;
+            }
+        }
+        metricsAdd(METRICS.delayMatrixEntries, (long long) dd.N * dd.N);
+        metricsAdd(METRICS.delayMatrixNonZeros, nonZeros);
+        metricsAdd(METRICS.delayMatrixBytes, dd.bytes());
+    }
+}
+
+void initializeLabels(std::vector<Node*>& master, int N, LabelingOptions& opts, LabelingResult& res){
+    res.labels.assign(N, 0);
+    res.clusters.clear();
+    res.labeledNodes = 0;
+    for(auto node : master){
+        //apply initial labeling
+        if(!opts.useLawler){
+            if(node->isPI) {
+                res.labels[node->id] = node->delay; //For RW, PIs start at node delay
+            }
+        }
+    }
+}
+
+//similar to addPredecessors, but only adds the node if it has the specified label
+static void get_lawler_cluster(std::vector<Node *> &nodes, Node* n, int p, std::vector<char>& visited, std::vector<int>& labels){
+    if (visited[n->id]) return;
+    if(labels[n->id] == p){
+        for(auto prev : n->prev){
+            get_lawler_cluster(nodes, prev, p, visited, labels);
+        }
+        visited[n->id] = true;
+        nodes.push_back(n);
+    }
+}
+
+static void lawler_cluster(Node* n, std::vector<Cluster> &clusters, std::vector<char>& clustered, std::vector<int>& labels){
+    //every predecessor of an already visited node has been visited as well
+    if(clustered[n->id]) return;
+    bool cluster = true;
+    for (auto suc : n->next) { //for each of n's successors
+        if (labels[n->id] == labels[suc->id]) {
+            cluster = false;
+        }
+    }
+    if (cluster) {
+        std::vector<Node *> clust;
+        std::vector<char> visited(n->id+1, false);
+        get_lawler_cluster(clust, n, labels[n->id], visited, labels);
+        Cluster newCluster(n->id);
+        for (auto c : clust) {
+            newCluster.members.push_back(c);
+        }
+        clusters.push_back(newCluster);
+    }
+    clustered[n->id] = true;
+    for(auto p : n->prev){
+        lawler_cluster(p, clusters, clustered, labels);
+    }
+}
+
+void LabelScratch::resize(size_t n){
+    visited.assign(n, false);
+    label_v.assign(n, 0);
+    coneDelay.assign(n, 0);
+    coneDepth8.assign(n, 0);
+    coneDepth16.assign(n, 0);
+    coneSize.assign(n, 0);
+}
+
+//longest path delay from every node of S (the fan-in cone of v, in topological order) to v,
+//using only the cone itself instead of a precomputed delay matrix
+template <bool UNIT>
+static void coneDelaysT(Node* v, std::vector<Node*>& S, std::vector<char>& visited, std::vector<int>& coneDelay){
+    for (auto it = S.rbegin(); it != S.rend(); ++it){
+        Node *x = *it;
+        int best = 0;
+        for (auto s : x->next){
+            int d;
+            if (s == v){
+                d = UNIT ? 1 : v->delay;
+            }
+            else if (s->id < v->id && visited[s->id]){
+                d = coneDelay[s->id] + (UNIT ? 1 : s->delay);
+            }
+            else {
+                continue; //not part of v's fan-in cone
+            }
+            best = (d > best) ? d : best;
+        }
+        coneDelay[x->id] = best;
+    }
+}
+
+void computeConeDelays(Node* v, std::vector<Node*>& S, std::vector<char>& visited, std::vector<int>& coneDelay){
+    coneDelaysT<false>(v, S, visited, coneDelay);
+}
+
+template <bool UNIT>
+void ConeDelayProvider<UNIT>::prepare(Node* v, std::vector<Node*>& S, LabelScratch& scratch){
+    coneDelaysT<UNIT>(v, S, scratch.visited, scratch.coneDelay);
+}
+
+static inline std::vector<uint8_t>& coneDepth(LabelScratch& scratch, uint8_t) { return scratch.coneDepth8; }
+static inline std::vector<uint16_t>& coneDepth(LabelScratch& scratch, uint16_t) { return scratch.coneDepth16; }
+static inline std::vector<int>& coneDepth(LabelScratch& scratch, int) { return scratch.coneDelay; }
+static inline const std::vector<uint8_t>& coneDepth(const LabelScratch& scratch, uint8_t) { return scratch.coneDepth8; }
+static inline const std::vector<uint16_t>& coneDepth(const LabelScratch& scratch, uint16_t) { return scratch.coneDepth16; }
+static inline const std::vector<int>& coneDepth(const LabelScratch& scratch, int) { return scratch.coneDelay; }
+
+template <typename T>
+void UnitDelayProvider<T>::prepare(Node* v, std::vector<Node*>& S, LabelScratch& scratch){
+    //every fan-in of a cone node is in the cone, so pushing delays backwards along fan-in edges
+    //touches exactly the cone's edges and needs no membership test
+    std::vector<T>& depth = coneDepth(scratch, T());
+    for (auto x : S){
+        depth[x->id] = 0;
+    }
+    for (auto p : v->prev){
+        depth[p->id] = 1;
+    }
+    for (auto it = S.rbegin(); it != S.rend(); ++it){
+        T d = depth[(*it)->id] + 1;
+        for (auto p : (*it)->prev){
+            if (depth[p->id] < d) depth[p->id] = d;
+        }
+    }
+}
+
+template <typename T>
+int UnitDelayProvider<T>::get(const Node* x, const Node*, const LabelScratch& scratch) const{
+    return coneDepth(scratch, T())[x->id];
+}
+
+//labeling order of S: decreasing label_v, then decreasing id (same as compare_lv)
+struct LabelVOrder {
+    const int *label_v;
+    const uint32_t *rank; //null: ids are the DFS positions
+    bool operator()(const Node* lhs, const Node* rhs) const {
+        if (label_v[lhs->id] == label_v[rhs->id]){
+            return rank ? rank[lhs->id] > rank[rhs->id] : lhs->id > rhs->id;
+        }
+        return label_v[lhs->id] > label_v[rhs->id]; //sorting should be in DECREASING order
+    }
+};
+
+//breadth first cone collection for giant cones: each frontier is split over the pool and nodes are
+//claimed with an atomic exchange on their visited flag; S does not end up in topological order
+static void collectConeParallel(Node* v, std::vector<Node*>& S, std::vector<char>& visited, TaskPool& pool){
+    std::mutex lock;
+    for (auto p : v->prev){
+        if (!visited[p->id]){
+            visited[p->id] = true;
+            S.push_back(p);
+        }
+    }
+    size_t begin = 0;
+    std::vector<Node*> next;
+    while (begin < S.size()){
+        size_t end = S.size();
+        next.clear();
+        pool.parallelFor(begin, end, PARALLEL_GRAIN / 4, [&](size_t lo, size_t hi){
+            std::vector<Node*> found;
+            for (size_t i=lo; i < hi; ++i){
+                for (auto p : S[i]->prev){
+                    if (!__atomic_exchange_n(&visited[p->id], (char) true, __ATOMIC_RELAXED)) found.push_back(p);
+                }
+            }
+            std::lock_guard<std::mutex> guard(lock);
+            next.insert(next.end(), found.begin(), found.end());
+        });
+        S.insert(S.end(), next.begin(), next.end());
+        begin = end;
+    }
+}
+
+//If u is the only fan-in of v, the cone of v is u's cone plus u and d(x, v) = d(x, u) + delay(v), so v's
+//best candidates are among u's best candidates (label_v shifted by delay(v), order unchanged) and u.
+//The candidates of u are kept until the last node with u as its only fan-in has been labeled.
+struct ChainCache {
+    std::vector<int> uses;  //nodes with this node as their only fan-in, not labeled yet
+    std::vector<std::vector<std::pair<Node *, int>>> top;  //(candidate, label_v) in labeling order
+
+    //nodes before first were labeled by an earlier run (resume), so their candidates are not cached
+    ChainCache(std::vector<Node*>& master, size_t N, size_t first) : uses(N, 0), top(N) {
+        for (size_t i = first; i < master.size(); ++i) {
+            Node *v = master[i];
+            if (v->prev.size() == 1 && v->prev[0]->id >= first) ++uses[v->prev[0]->id];
+        }
+    }
+};
+
+//calls opts.checkpoint every checkpointIntervalMs of labeling
+class CheckpointClock {
+public:
+    explicit CheckpointClock(LabelingOptions& opts) : opts(opts), countdown(CHECKPOINT_STRIDE) {
+        last = std::chrono::steady_clock::now();
+    }
+    void tick(LabelingResult& res){
+        if (!opts.checkpoint || --countdown > 0) return;
+        countdown = CHECKPOINT_STRIDE;
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration_cast<std::chrono::milliseconds>(now - last).count() < opts.checkpointIntervalMs) return;
+        opts.checkpoint(res);
+        last = std::chrono::steady_clock::now();
+    }
+
+private:
+    LabelingOptions& opts;
+    int countdown;
+    std::chrono::steady_clock::time_point last;
+};
+
+template <class Provider>
+static void labelNodeRWT(Node* v, Provider& delays, LabelingOptions& opts, std::vector<int>& labels,
+                         LabelScratch& scratch, Cluster& cl, TaskPool* pool = nullptr, ChainCache* chains = nullptr){
+    std::vector<Node *>& S = scratch.S;
+    std::vector<char>& visited = scratch.visited;
+    std::vector<int>& label_v = scratch.label_v;
+    std::vector<Node *>& top = scratch.top;
+    S.clear();
+    top.clear();
+    size_t k = (opts.maxClusterSize > 1) ? opts.maxClusterSize : 1;
+    LabelVOrder order = {label_v.data(), opts.tieRank};
+
+    size_t coneSize;
+    Node *u = (v->prev.size() == 1) ? v->prev[0] : nullptr;
+    if (chains != nullptr && u != nullptr && chains->uses[u->id] > 0) {
+        std::vector<std::pair<Node *, int>>& cached = chains->top[u->id];
+        for (auto& c : cached) {
+            label_v[c.first->id] = c.second + v->delay;
+            top.push_back(c.first);
+        }
+        label_v[u->id] = labels[u->id] + v->delay;
+        top.push_back(u);
+        if (--chains->uses[u->id] == 0) {
+            std::vector<std::pair<Node *, int>>().swap(cached);
+        }
+        metricsAdd(METRICS.chainReuses, 1);
+        metricsAdd(METRICS.sortedElements, top.size());
+        size_t best = std::min(k, top.size());
+        std::partial_sort(top.begin(), top.begin() + best, top.end(), order);
+        top.resize(best);
+        coneSize = scratch.coneSize[u->id] + 1;
+    }
+    else {
+        //skip PIs (label(PI) = delay(pi) already implemented)
+        if (!v->prev.empty()) {
+            //the cone of a fan-in (labeled earlier) is a lower bound for the cone of v
+            int estimate = 0;
+            for (auto n : v->prev) {
+                estimate = (scratch.coneSize[n->id] + 1 > estimate) ? scratch.coneSize[n->id] + 1 : estimate;
+            }
+            if (pool != nullptr && !Provider::topologicalCone && estimate >= opts.parallelConeMin) {
+                collectConeParallel(v, S, visited, *pool);
+            }
+            else {
+                for (auto n : v->prev) {
+                    collectPredecessors(S, n, visited);
+                }
+            }
+        }
+
+        // calculate label_v(x) and keep the maxClusterSize best candidates: maxClusterSize-1 join the
+        // cluster and the next one sets L2, so the rest of S never needs to be ordered
+        delays.prepare(v, S, scratch);
+        if (pool != nullptr && (int) S.size() >= opts.parallelConeMin) {
+            //every chunk scores its part of S and offers its own top k
+            std::mutex lock;
+            pool->parallelFor(0, S.size(), PARALLEL_GRAIN, [&](size_t lo, size_t hi){
+                for (size_t i=lo; i < hi; ++i) {
+                    label_v[S[i]->id] = labels[S[i]->id] + delays.get(S[i], v, scratch);
+                }
+                size_t best = std::min(k, hi - lo);
+                std::partial_sort(S.begin() + lo, S.begin() + lo + best, S.begin() + hi, order);
+                std::lock_guard<std::mutex> guard(lock);
+                top.insert(top.end(), S.begin() + lo, S.begin() + lo + best);
+            });
+            size_t best = std::min(k, top.size());
+            std::partial_sort(top.begin(), top.begin() + best, top.end(), order);
+            top.resize(best);
+        }
+        else {
+            for (auto x : S) {
+                label_v[x->id] = labels[x->id] + delays.get(x, v, scratch);
+            }
+            size_t best = std::min(k, S.size());
+            std::partial_sort(S.begin(), S.begin() + best, S.end(), order);
+            top.assign(S.begin(), S.begin() + best);
+        }
+        //only the cone was marked, so clearing it readies the flags for the next node
+        for (auto x : S) {
+            visited[x->id] = false;
+        }
+        metricsAdd(METRICS.sortedElements, S.size());
+        coneSize = S.size();
+    }
+    scratch.coneSize[v->id] = coneSize;
+    metricsRecordCone(coneSize);
+    if (chains != nullptr && chains->uses[v->id] > 0) {
+        for (auto x : top) {
+            chains->top[v->id].push_back(std::make_pair(x, label_v[x->id]));
+        }
+    }
+
+    cl.members.push_back(v);
+
+    cl.tieFree = true;
+    for (size_t i = 1; i < top.size(); ++i) {
+        if (label_v[top[i]->id] == label_v[top[i - 1]->id]) cl.tieFree = false;
+    }
+
+    // take elements from the front of the ordered candidates and add to c until max cluster size reached or S is exhausted
+    size_t next = 0;
+    for (int i = 1; i < opts.maxClusterSize; ++i) { //i starts at 1 to include initial element already in cluster
+        if (next == top.size()) break;
+        cl.members.push_back(top[next]);
+        ++next;
+    }
+
+    if (!v->prev.empty()) {
+        int L2 = 0;
+        if (next < coneSize) {
+            L2 = label_v[top[next]->id] + opts.interClusterDelay;
+        }
+        // let l1 = max(label_v) of any PI node in cluster(v)
+        int L1 = 0;
+        for (auto mem : cl.members) {
+            if (mem->isPI && label_v[mem->id] > L1) {
+                L1 = label_v[mem->id];
+            }
+        }
+
+        labels[v->id] = (L1 > L2) ? L1 : L2;
+    }
+    generateInputSet(cl);
+}
+
+//labels a single node, the provider is picked per call
+struct LabelOneRW {
+    Node *v;
+    LabelingOptions& opts;
+    std::vector<int>& labels;
+    LabelScratch& scratch;
+    Cluster& cl;
+    template <class Provider>
+    void operator()(Provider& delays){
+        labelNodeRWT(v, delays, opts, labels, scratch, cl);
+    }
+};
+
+void labelNodeRW(Node* v, std::vector<Node*>& master, DelayData& dd, LabelingOptions& opts,
+                 std::vector<int>& labels, LabelScratch& scratch, Cluster& cl){
+    LabelOneRW op = {v, opts, labels, scratch, cl};
+    dispatchDelayProvider(dd, master, op);
+}
+
+//labels every node in topological order; one instantiation per provider keeps the loop free of mode checks
+struct LabelAllRW {
+    std::vector<Node*>& master;
+    LabelingOptions& opts;
+    LabelingResult& res;
+    bool reuseChains;  //single fan-in chains may shift their fan-in's candidates (needs positive delays)
+    template <class Provider>
+    void operator()(Provider& delays){
+        std::vector<int>& labels = res.labels;
+        LabelScratch scratch;
+        scratch.resize(labels.size());
+        res.clusters.reserve(master.size());
+        //helper threads only pay off if some cone can reach the parallel size
+        int threads = labelThreadCount(opts.labelThreads);
+        std::unique_ptr<TaskPool> pool;
+        if (threads > 1 && (int) master.size() > opts.parallelConeMin) {
+            pool.reset(new TaskPool(threads));
+        }
+        std::unique_ptr<ChainCache> chains;
+        if (reuseChains) {
+            chains.reset(new ChainCache(master, labels.size(), res.labeledNodes));
+        }
+
+        ProgressMeter progress("labeling", "nodes", master.size());
+        CheckpointClock checkpoint(opts);
+        for (size_t i = res.labeledNodes; i < master.size(); ++i) {
+            if (interruptRequested()) break;
+            progress.update(i);
+            Node *v = master[i];
+            TraceSpan span("label_node", "labeling", true);
+            Cluster cl(v->id);
+            labelNodeRWT(v, delays, opts, labels, scratch, cl, pool.get(), chains.get());
+            if (span.active()) {
+                span.arg("node", v->strID);
+                span.arg("cone", scratch.coneSize[v->id]);
+                span.arg("label", labels[v->id]);
+            }
+            res.maxLabel = (labels[v->id] > res.maxLabel) ? labels[v->id] : res.maxLabel;
+            res.clusters.push_back(cl);
+            res.labeledNodes = res.clusters.size();
+            if (opts.nodeLabeled) opts.nodeLabeled(i);
+            checkpoint.tick(res);
+        }
+        progress.finish(res.labeledNodes);
+    }
+};
+
+void computeLabels(std::vector<Node*>& master, std::vector<Node*>& POs, DelayData& dd, LabelingOptions& opts, LabelingResult& res){
+    std::vector<int>& labels = res.labels;
+    std::vector<char> visited(labels.size(), false);
+    //a run resumed from a checkpoint keeps the labels, clusters and maxima of its first labeledNodes nodes
+    if (res.labeledNodes == 0) {
+        res.maxLabel = 0;
+        res.maxIODelay = 0;
+    }
+    res.clusters.resize(opts.useLawler ? 0 : res.labeledNodes, Cluster(0));
+    res.interrupted = false;
+    if (opts.nodeLabeled) {
+        for (size_t i = 0; i < res.labeledNodes; ++i) opts.nodeLabeled(i); //restored from a checkpoint
+    }
+    if(!opts.useLawler) {
+
+    // Let Gv be the subgraph containing v and all its predecessors
+        // label_v(x) for all x in Gv\{v}
+            // label_v(x) = label(x) + delay_matrix[x][v]
+    // Let S be the set of nodes in Gv\{v} sorted by decreasing label_v values
+        // remove node one-by-one in sorted order  from S and add it to cluster(v) until size constraint is met
+        // let l1 = max(label_v) of any PI node in cluster(v)
+        // let l2 = max(label_v+delay) of any node remaining in S
+        // label(v) = max(l1,l2)
+
+        LabelAllRW op = {master, opts, res, dd.positiveDelay};
+        dispatchDelayProvider(dd, master, op);
+    }
+    else{
+        // LAWLER LABELING ALGORITHM
+        // For each PI node, label = 0 (already implemented above)
+        // For each non PI node v
+            // p = maximum label of predecessors
+            // Xp = set of predecessors with label p
+            // if |Xp| < MAX_CLUSTER_SIZE
+                // L(v) = p
+            // else
+                // L(v) = p+1
+        // nodes with the same label go in the same cluster
+
+        ProgressMeter progress("labeling", "nodes", master.size());
+        CheckpointClock checkpoint(opts);
+        //traversing in topological order guarantees all predecessors of v will be labeled
+        for (size_t i = res.labeledNodes; i < master.size(); ++i) {
+            if (interruptRequested()) break;
+            progress.update(i);
+            Node *v = master[i];
+            TraceSpan span("lawler_label_node", "labeling", true);
+            if(!v->isPI){
+                int max = 0;
+                int count = 0;
+                std::vector<Node *> pre;
+                for(auto n : v->prev){
+                    collectPredecessors(pre, n, visited);
+                }
+                for(auto p : pre){ //reset the predecessors' visited flags for the next node
+                    visited[p->id] = false;
+                }
+                metricsRecordCone(pre.size());
+                if (span.active()) {
+                    span.arg("node", v->strID);
+                    span.arg("cone", pre.size());
+                }
+                for(auto p : pre){
+                    if(labels[p->id] == max){ //keep a count of the number of predecessors with max label
+                        ++count;
+                    }
+                    else if(labels[p->id] > max){
+                        max = labels[p->id];
+                        count = 1;
+                    }
+                    int d = dd.unitDelay ? maxDelayT<true>(p, v, master) : maxDelayT<false>(p, v, master);
+                    res.maxIODelay = (d > res.maxIODelay) ? d : res.maxIODelay;
+                }
+                if(count < opts.maxClusterSize){
+                    labels[v->id] = max;
+                }
+                else{
+                    labels[v->id] = max+1;
+                }
+            }
+            res.maxLabel = (labels[v->id] > res.maxLabel) ? labels[v->id] : res.maxLabel;
+            ++res.labeledNodes;
+            if (opts.nodeLabeled) opts.nodeLabeled(i);
+            checkpoint.tick(res);
+        }
+        progress.finish(res.labeledNodes);
+        //prepare for recursive clustering, keep a clustered flag so we only add each node once
+        std::vector<char> clustered(labels.size(), false);
+        if (res.labeledNodes == master.size()){
+            for(auto PO : POs){
+                lawler_cluster(PO, res.clusters, clustered, labels);
+            }
+        }
+    }
+    if (res.labeledNodes < master.size()){
+        //stopped by SIGINT: nodes that were not reached keep their initial label and an empty cluster
+        res.interrupted = true;
+        if (!opts.useLawler){
+            for (size_t i = res.clusters.size(); i < master.size(); ++i){
+                res.clusters.push_back(Cluster(master[i]->id));
+            }
+        }
+    }
+}
+
+//coverage of the non-overlap (--exp) clustering walk: one bit per covered node, the number of uncovered
+//members of every cluster, and for every node the clusters it is a member of, so covering a node
+//updates each count it affects and "are all members of cluster(v) covered" is a single lookup
+struct CoverageTracker {
+    std::vector<uint64_t> covered;
+    std::vector<int> uncovered;         //indexed by cluster (= node) id
+    std::vector<uint64_t> ownerOffset;  //clusters containing node n: owners[ownerOffset[n] .. ownerOffset[n+1])
+    std::vector<uint32_t> owners;
+
+    void build(std::vector<Cluster>& clusters, size_t N, LabelingOptions& opts);
+    void cover(uint32_t n){
+        if (covered[n >> 6] & (1ULL << (n & 63))) return;
+        covered[n >> 6] |= 1ULL << (n & 63);
+        for (uint64_t i = ownerOffset[n]; i < ownerOffset[n+1]; ++i){
+            --uncovered[owners[i]];
+        }
+    }
+};
+
+void CoverageTracker::build(std::vector<Cluster>& clusters, size_t N, LabelingOptions& opts){
+    //two passes over every cluster member (count, then fill), split over the label threads for large netlists
+    covered.assign((N + 63) / 64, 0);
+    uncovered.assign(N, 0);
+    std::vector<uint64_t> cursor(N + 1, 0);
+    std::unique_ptr<TaskPool> pool;
+    int threads = labelThreadCount(opts.labelThreads);
+    if (threads > 1 && (int) clusters.size() > opts.parallelConeMin){
+        pool.reset(new TaskPool(threads));
+    }
+    auto forClusters = [&](const TaskPool::RangeBody& body){
+        if (pool) pool->parallelFor(0, clusters.size(), PARALLEL_GRAIN, body);
+        else body(0, clusters.size());
+    };
+    forClusters([&](size_t lo, size_t hi){
+        for (size_t c = lo; c < hi; ++c){
+            uncovered[clusters[c].id] = clusters[c].members.size();
+            for (auto m : clusters[c].members){
+                __atomic_fetch_add(&cursor[m->id + 1], 1, __ATOMIC_RELAXED);
+            }
+        }
+    });
+    for (size_t n = 0; n < N; ++n){
+        cursor[n + 1] += cursor[n];
+    }
+    ownerOffset = cursor;
+    owners.assign(cursor[N], 0);
+    forClusters([&](size_t lo, size_t hi){
+        for (size_t c = lo; c < hi; ++c){
+            for (auto m : clusters[c].members){
+                owners[__atomic_fetch_add(&cursor[m->id], 1, __ATOMIC_RELAXED)] = clusters[c].id;
+            }
+        }
+    });
+}
+
+void computeClusters(std::vector<Node*>& master, std::vector<Node*>& POs, LabelingOptions& opts, LabelingResult& res){
+    std::vector<Cluster>& clusters = res.clusters;
+    res.finalClusterList.clear();
+    res.lHistory.clear();
+    if (res.interrupted) return; //clusters of unlabeled nodes are empty, there is nothing to select from
+    if(!opts.useLawler) { //for RW
+        //CLUSTERING PHASE
+        std::vector<Node *> L;
+
+        std::copy(POs.begin(), POs.end(), std::back_inserter(L)); //Generate L as the set of all POs in the circuit
+        if (opts.useGui){
+            res.lHistory.push_back(L);
+        }
+        //using visited flag to tell if a node has been placed into the final cluster list
+        std::vector<char> visited(res.labels.size(), false);
+
+        if (opts.useExp2){
+            //experimental code to remove redundant clusters
+            //Iterate through node list in reverse topological order
+            //If a node is unvisited, add the cluster for which this node is the head
+            //For each node in the added cluster, set visited
+            //DOES NOT SUPPORT GUI
+            for(auto it = master.rbegin(); it != master.rend(); ++it){
+                if (interruptRequested()) {
+                    res.interrupted = true;
+                    break;
+                }
+                if(!visited[(*it)->id]) {
+                    Cluster *cl = &(clusters.at((*it)->id));
+                    res.finalClusterList.push_back(cl);
+                    if (opts.clusterSelected) opts.clusterSelected(cl);
+                    for(auto member : cl->members){
+                        visited[member->id] = true;
+                    }
+                }
+            }
+        }
+        else {
+            //L is consumed from the front; head marks the first node still queued
+            size_t head = 0;
+            std::vector<char> queued(res.labels.size(), false);
+            std::vector<char> listed(res.labels.size(), false); //cluster(id) is in finalClusterList
+            for (auto po : L) queued[po->id] = true;
+            CoverageTracker coverage;
+            if (opts.useExp) {
+                coverage.build(clusters, res.labels.size(), opts);
+            }
+            ProgressMeter progress("clustering", "clusters", L.size());
+            while (head < L.size()) {
+                if (interruptRequested()) {
+                    res.interrupted = true;
+                    break;
+                }
+                progress.setTotal(L.size());
+                progress.update(head);
+                //retrieve first element of L and pop from L
+                Node *lNode = L[head++];
+                queued[lNode->id] = false;
+
+                //add cluster to finalClusterList
+                Cluster *cl = &(clusters.at(lNode->id));
+                res.finalClusterList.push_back(cl);
+                if (opts.clusterSelected) opts.clusterSelected(cl);
+                listed[lNode->id] = true;
+
+                if (opts.useExp) {
+                    //Experiment Method: skip input clusters whose members are all covered by queued clusters
+                    for (auto iNode : cl->inputSet) {
+                        bool alreadyAdded = coverage.uncovered[iNode->id] == 0;
+                        if (!alreadyAdded && !queued[iNode->id]) {
+                            L.push_back(iNode);
+                            queued[iNode->id] = true;
+                            metricsAdd(METRICS.queuePushes, 1);
+                            for(Node* n : clusters.at(iNode->id).members){
+                                coverage.cover(n->id);
+                            }
+                        }
+                    }
+                } else {
+                    //add any node in input(lNode's cluster) whose cluster is not in the finalClusterList
+                    for (auto iNode : cl->inputSet) {
+                        if (!listed[iNode->id] && !queued[iNode->id]) {
+                            L.push_back(iNode);
+                            queued[iNode->id] = true;
+                            metricsAdd(METRICS.queuePushes, 1);
+                        }
+                    }
+                }
+
+
+                metricsMax(METRICS.queueMax, L.size() - head);
+                traceCounter("cluster_queue", L.size() - head);
+                if (opts.useGui) {
+                    res.lHistory.push_back(std::vector<Node *>(L.begin() + head, L.end()));
+                }
+            }
+            progress.finish(head);
+        }
+    }
+    else{ //for lawler labeling, just insert clusters into final cluster list as they are
+        for(auto it = clusters.begin(); it != clusters.end(); ++it){
+            res.finalClusterList.push_back(&(*it));
+            if (opts.clusterSelected) opts.clusterSelected(&(*it));
+        }
+    }
+}
+
+void finalizeResult(LabelingOptions& opts, LabelingResult& res){
+    res.maxIODelayLawlerModified = res.maxIODelay;
+    if (!opts.useLawler){
+        //RW Clustering has max label = max PI-PO delay
+        res.maxIODelay = res.maxLabel;
+    }
+    else {
+        res.maxIODelay = res.maxIODelay + res.maxLabel;
+        res.maxIODelayLawlerModified = res.maxIODelay + res.maxLabel*opts.interClusterDelay;
+    }
+    res.clusterAreaCost = 0;
+    for (auto cl : res.finalClusterList){
+        res.clusterAreaCost += cl->members.size();
+    }
+}
+
+void applyLabels(std::vector<Node*>& master, LabelingResult& res){
+    for (auto n : master){
+        n->label = res.labels[n->id];
+    }
+}
@@ -0,0 +1,62 @@
+//
+// Allocation of the large delay tables: anonymous mappings with a transparent huge page hint
+//
+
+#include "../include/LargeAlloc.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+
+static bool useHugePages = true;
+
+void setHugePages(bool enabled){
+    useHugePages = enabled;
+}
+
+static size_t mappedLength(size_t bytes){
+    return (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+}
+
+void* allocateLarge(size_t bytes){
+    if (bytes < LARGE_ALLOC_MIN){
+        void* p = calloc(bytes ? bytes : 1, 1);
+        if (p == nullptr) throw std::bad_alloc();
+        return p;
+    }
+    //over-allocate by one huge page and trim both ends so the block starts on a huge page boundary
+    size_t length = mappedLength(bytes);
+    void* raw = mmap(nullptr, length + HUGE_PAGE_BYTES, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) throw std::bad_alloc();
+    uintptr_t start = ((uintptr_t) raw + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+    size_t head = start - (uintptr_t) raw;
+    if (head > 0) munmap(raw, head);
+    if (HUGE_PAGE_BYTES - head > 0) munmap((char*) start + length, HUGE_PAGE_BYTES - head);
+#if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+    madvise((void*) start, length, useHugePages ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+#endif
+    return (void*) start;
+}
+
+void releaseLarge(void* p, size_t bytes){
+    if (p == nullptr) return;
+    if (bytes < LARGE_ALLOC_MIN) free(p);
+    else munmap(p, mappedLength(bytes));
+}
+
+long long hugePagesKB(){
+    FILE* file = fopen("/proc/self/smaps_rollup", "r");
+    if (file == NULL) return -1;
+    long long result = -1;
+    char line[128];
+    while (fgets(line, 128, file) != NULL){
+        if (strncmp(line, "AnonHugePages:", 14) == 0){
+            result = atoll(line + 14);
+            break;
+        }
+    }
+    fclose(file);
+    return result;
+}
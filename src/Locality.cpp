@@ -0,0 +1,119 @@
+//
+// Locality renumbering: a topological order that keeps connected logic close together in the id space
+//
+
+#include "../include/Locality.h"
+#include <algorithm>
+
+//ids double as positions while the orders are compared; initializeLabels numbers the final one again
+static void numberByPosition(std::vector<Node*>& order){
+    uint32_t id = 0;
+    for (auto n : order){
+        n->id = id++;
+    }
+}
+
+LocalityMetrics measureLocality(std::vector<Node*>& master){
+    //Description: numbers master by position. Only nodes of master count (visited by sortTopologically)
+    LocalityMetrics m;
+    numberByPosition(master);
+    double distance = 0;
+    uint64_t edges = 0;
+    for (auto v : master){
+        for (auto u : v->prev){
+            distance += v->id - u->id;
+            ++edges;
+        }
+    }
+    m.meanFaninDistance = edges ? distance / edges : 0;
+    //the fan-out cone of r starts at its first direct fan-out and ends at the furthest node any fan-out reaches
+    std::vector<int64_t> reach(master.size(), -1);
+    for (size_t i = master.size(); i-- > 0;){
+        int64_t first = -1;
+        int64_t last = -1;
+        for (auto w : master[i]->next){
+            if (!w->visited) continue;
+            first = (first < 0 || w->id < first) ? w->id : first;
+            last = std::max(last, std::max<int64_t>(w->id, reach[w->id]));
+        }
+        reach[i] = last;
+        if (first >= 0) m.sparseRowCells += last - first + 1;
+    }
+    return m;
+}
+
+static void addPredecessorsDeepestFirst(std::vector<Node*>& out, Node* n, std::vector<int>& level, std::vector<char>& seen){
+    if (seen[n->id]) return;
+    seen[n->id] = true;
+    //the deepest fan-in cone first: the shallow ones, placed last, sit right before n
+    std::vector<Node*> fanins(n->prev);
+    std::stable_sort(fanins.begin(), fanins.end(), [&](const Node* a, const Node* b){
+        return level[a->id] > level[b->id];
+    });
+    for (auto u : fanins){
+        if (!seen[u->id]) addPredecessorsDeepestFirst(out, u, level, seen);
+    }
+    out.push_back(n);
+}
+
+//one refinement round: POs ordered by the first node of their fan-in cone in the current order
+static std::vector<Node*> clusterCones(std::vector<Node*>& current, std::vector<Node*>& POs){
+    numberByPosition(current);
+    std::vector<int> level(current.size(), 0);
+    std::vector<uint32_t> low(current.size());
+    for (auto v : current){
+        low[v->id] = v->id;
+        for (auto u : v->prev){
+            level[v->id] = std::max(level[v->id], level[u->id] + 1);
+            low[v->id] = std::min(low[v->id], low[u->id]);
+        }
+    }
+    std::vector<Node*> roots(POs);
+    std::stable_sort(roots.begin(), roots.end(), [&](const Node* a, const Node* b){
+        return low[a->id] < low[b->id];
+    });
+    std::vector<Node*> order;
+    order.reserve(current.size());
+    std::vector<char> seen(current.size(), false);
+    for (auto po : roots){
+        addPredecessorsDeepestFirst(order, po, level, seen);
+    }
+    return order;
+}
+
+static bool moreLocal(const LocalityMetrics& a, const LocalityMetrics& b){
+    if (a.sparseRowCells != b.sparseRowCells) return a.sparseRowCells < b.sparseRowCells;
+    return a.meanFaninDistance < b.meanFaninDistance;
+}
+
+void renumberForLocality(std::vector<Node*>& master, std::vector<Node*>& POs, std::vector<uint32_t>& tieRank,
+                         LocalityStats& stats){
+    std::vector<Node*> original(master);
+    stats.before = measureLocality(master);
+    stats.after = stats.before;
+    stats.applied = false;
+    tieRank.clear();
+    //a second round starts from the first one's (already grouped) order and usually tightens it further
+    std::vector<Node*> best;
+    std::vector<Node*> current(master);
+    for (int round = 0; round < 2; ++round){
+        current = clusterCones(current, POs);
+        LocalityMetrics m = measureLocality(current);
+        if (moreLocal(m, stats.after)){
+            stats.after = m;
+            best = current;
+        }
+    }
+    if (best.empty()){
+        numberByPosition(master);
+        return;
+    }
+    numberByPosition(original);
+    tieRank.resize(best.size());
+    for (size_t i = 0; i < best.size(); ++i){
+        tieRank[i] = best[i]->id;
+    }
+    master.swap(best);
+    numberByPosition(master);
+    stats.applied = true;
+}
@@ -0,0 +1,95 @@
+//
+// Per-structure memory accounting and peak RSS samples at phase boundaries (--mem_report)
+//
+
+#include "../include/MemoryStats.h"
+#include "../include/LargeAlloc.h"
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+long long procStatusKB(const char* field){
+    FILE* file = fopen("/proc/self/status", "r");
+    if (file == NULL) return -1;
+    long long result = -1;
+    size_t len = strlen(field);
+    char line[128];
+    while (fgets(line, 128, file) != NULL){
+        if (strncmp(line, field, len) == 0 && line[len] == ':'){
+            result = atoll(line + len + 1);
+            break;
+        }
+    }
+    fclose(file);
+    return result;
+}
+
+void MemoryReport::sample(std::string phase){
+    MemorySample s;
+    s.phase = phase;
+    s.rssKB = procStatusKB("VmRSS");
+    s.hwmKB = procStatusKB("VmHWM");
+    s.hugePagesKB = hugePagesKB();
+    samples.push_back(s);
+}
+
+//heap bytes of a string; short strings live inside the object
+static long long stringHeapBytes(const std::string& str){
+    return (str.capacity() > 15) ? str.capacity() + 1 : 0;
+}
+
+template <typename T>
+static long long vectorBytes(const std::vector<T>& v){
+    return v.capacity() * sizeof(T);
+}
+
+void measureStructures(MemoryReport& report, std::vector<Node>& rawNodeList, std::vector<Node*>& master,
+                       DelayData& dd, LabelingResult& res){
+    long long adjacency = 0;
+    long long strings = 0;
+    for (auto& n : rawNodeList){
+        adjacency += vectorBytes(n.prev) + vectorBytes(n.next);
+        strings += stringHeapBytes(n.strID) + stringHeapBytes(n.procStr);
+    }
+    long long delayMatrix = dd.bytes();
+    long long clusters = vectorBytes(res.clusters);
+    for (auto& cl : res.clusters){
+        clusters += vectorBytes(cl.members) + vectorBytes(cl.inputSet);
+    }
+    long long clusterLists = vectorBytes(res.finalClusterList) + vectorBytes(res.lHistory);
+    for (auto& l : res.lHistory){
+        clusterLists += vectorBytes(l);
+    }
+
+    report.structures.push_back({"NODE LIST", vectorBytes(rawNodeList)});
+    report.structures.push_back({"ADJACENCY (PREV/NEXT)", adjacency});
+    report.structures.push_back({"NODE NAMES AND BLIF LINES", strings});
+    report.structures.push_back({"TOPOLOGICAL ORDER", vectorBytes(master)});
+    report.structures.push_back({"DELAY MATRIX", delayMatrix});
+    report.structures.push_back({"LABELS", vectorBytes(res.labels)});
+    report.structures.push_back({"CLUSTERS", clusters});
+    report.structures.push_back({"FINAL CLUSTER LIST AND L HISTORY", clusterLists});
+}
+
+static std::string kilobytes(long long bytes){
+    return std::to_string((bytes + 1023) / 1024) + "KB";
+}
+
+void writeMemoryReport(std::ostream& out, std::ostream& verboseFile, MemoryReport& report){
+    long long total = 0;
+    out << "-----------MEMORY BREAKDOWN------------" << std::endl;
+    verboseFile << "\n-----------MEMORY BREAKDOWN------------\n" << std::endl;
+    for (auto& s : report.structures){
+        out << s.name << ":\t" << kilobytes(s.bytes) << std::endl;
+        verboseFile << s.name << ":\t" << kilobytes(s.bytes) << std::endl;
+        total += s.bytes;
+    }
+    out << "TOTAL ACCOUNTED:\t" << kilobytes(total) << std::endl;
+    verboseFile << "TOTAL ACCOUNTED:\t" << kilobytes(total) << std::endl;
+    out << "-----------PEAK RSS BY PHASE------------" << std::endl;
+    verboseFile << "\n-----------PEAK RSS BY PHASE------------\n" << std::endl;
+    for (auto& s : report.samples){
+        out << s.phase << ":\tRSS " << s.rssKB << "KB, PEAK " << s.hwmKB << "KB, HUGE PAGES " << s.hugePagesKB << "KB" << std::endl;
+        verboseFile << s.phase << ":\tRSS " << s.rssKB << "KB, PEAK " << s.hwmKB << "KB, HUGE PAGES " << s.hugePagesKB << "KB" << std::endl;
+    }
+}
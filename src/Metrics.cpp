@@ -0,0 +1,92 @@
+//
+// Machine readable run metrics (--metrics out.json)
+//
+
+#include "../include/Metrics.h"
+#include "../include/common.h"
+#include <fstream>
+
+Metrics METRICS;
+
+Metrics::Metrics(){
+    for (int i=0; i < METRICS_CONE_BUCKETS; ++i){
+        coneHistogram[i] = 0;
+    }
+}
+
+void metricsRecordCone(uint64_t size){
+    if (!METRICS.enabled) return;
+    //bucket b holds sizes in [2^(b-1), 2^b), bucket 0 holds empty cones
+    int bucket = 0;
+    while (bucket < METRICS_CONE_BUCKETS-1 && (size >> bucket) != 0){
+        ++bucket;
+    }
+    METRICS.cones.fetch_add(1, std::memory_order_relaxed);
+    METRICS.coneNodes.fetch_add(size, std::memory_order_relaxed);
+    METRICS.coneHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    metricsMax(METRICS.coneMax, size);
+}
+
+void metricsRecordPhase(std::string circuit, std::string phase, long long ns){
+    if (!METRICS.enabled) return;
+    std::lock_guard<std::mutex> guard(METRICS.phaseLock);
+    Metrics::Phase p;
+    p.circuit = circuit;
+    p.name = phase;
+    p.ns = ns;
+    METRICS.phases.push_back(p);
+}
+
+void metricsRecordMemory(std::string circuit, std::string name, long long bytes){
+    if (!METRICS.enabled) return;
+    std::lock_guard<std::mutex> guard(METRICS.phaseLock);
+    Metrics::Memory m;
+    m.circuit = circuit;
+    m.name = name;
+    m.bytes = bytes;
+    METRICS.memory.push_back(m);
+}
+
+bool writeMetricsFile(std::string filename, std::vector<std::pair<std::string,std::string>>& parameters){
+    std::ofstream out(filename);
+    if (!out.is_open()) return false;
+    Metrics& m = METRICS;
+    out << "{\n  \"version\": 1,\n  \"parameters\": {";
+    for (size_t i=0; i < parameters.size(); ++i){
+        out << (i ? ", " : "") << jsonString(parameters[i].first) << ": " << jsonString(parameters[i].second);
+    }
+    out << "},\n  \"phases\": [";
+    for (size_t i=0; i < m.phases.size(); ++i){
+        out << (i ? ",\n    " : "\n    ") << "{\"circuit\": " << jsonString(m.phases[i].circuit)
+            << ", \"phase\": " << jsonString(m.phases[i].name) << ", \"ns\": " << m.phases[i].ns << "}";
+    }
+    out << "\n  ],\n  \"memory\": [";
+    for (size_t i=0; i < m.memory.size(); ++i){
+        out << (i ? ",\n    " : "\n    ") << "{\"circuit\": " << jsonString(m.memory[i].circuit)
+            << ", \"name\": " << jsonString(m.memory[i].name) << ", \"bytes\": " << m.memory[i].bytes << "}";
+    }
+    out << "\n  ],\n  \"counters\": {\n";
+    out << "    \"cones\": " << m.cones << ",\n";
+    out << "    \"cone_nodes_total\": " << m.coneNodes << ",\n";
+    out << "    \"cone_size_max\": " << m.coneMax << ",\n";
+    out << "    \"sorted_elements\": " << m.sortedElements << ",\n";
+    out << "    \"chain_reuses\": " << m.chainReuses << ",\n";
+    out << "    \"max_delay_calls\": " << m.maxDelayCalls << ",\n";
+    out << "    \"cluster_queue_pushes\": " << m.queuePushes << ",\n";
+    out << "    \"cluster_queue_max\": " << m.queueMax << ",\n";
+    out << "    \"delay_matrix_entries\": " << m.delayMatrixEntries << ",\n";
+    out << "    \"delay_matrix_nonzeros\": " << m.delayMatrixNonZeros << ",\n";
+    out << "    \"delay_matrix_bytes\": " << m.delayMatrixBytes << "\n";
+    out << "  },\n  \"cone_size_histogram\": [";
+    bool first = true;
+    for (int b=0; b < METRICS_CONE_BUCKETS; ++b){
+        if (m.coneHistogram[b] == 0) continue;
+        uint64_t lo = (b == 0) ? 0 : ((uint64_t) 1 << (b-1));
+        uint64_t hi = (b == 0) ? 0 : ((uint64_t) 1 << b) - 1;
+        out << (first ? "\n    " : ",\n    ") << "{\"min\": " << lo << ", \"max\": " << hi << ", \"count\": " << m.coneHistogram[b] << "}";
+        first = false;
+    }
+    out << "\n  ]\n}\n";
+    out.close();
+    return true;
+}
@@ -0,0 +1,107 @@
+//
+// Background writer of the table, verbose and cluster output files, fed while labeling and clustering run
+//
+
+#include "../include/OutputWriter.h"
+#include "../include/common.h"
+#include "../include/Trace.h"
+
+#define OUTPUT_BATCH_RECORDS 4096 //rows handed to the writer thread at once
+
+OutputWriter::OutputWriter(std::string circuitName, int maxClusterSize, int interClusterDelay, int piDelay,
+                           int poDelay, int nodeDelay, int useLawlerLabeling, int useGui, int useExp){
+    lawler = useLawlerLabeling;
+    tooLargeForTable = maxClusterSize > CLUSTER_SIZE_LIMIT;
+    clusterSection = false;
+    nodeCount = 0;
+    done = false;
+    resultTable.open("output_" + circuitName + "_table.csv");
+    verboseResult.open("output_" + circuitName + "_verbose.txt");
+    clustrTable.open("output_" + circuitName + "_cluster.csv");
+    writeOutputHeaders(resultTable, verboseResult, clustrTable, circuitName, maxClusterSize, interClusterDelay,
+                       piDelay, poDelay, nodeDelay, useLawlerLabeling, useGui, useExp);
+    filling.records.reserve(OUTPUT_BATCH_RECORDS);
+    thread = std::thread([this](){
+        traceThreadName("output writer");
+        writerLoop();
+    });
+}
+
+OutputWriter::~OutputWriter(){
+    finish();
+}
+
+void OutputWriter::node(const Node* n, int label, const std::vector<Node*>* members){
+    ++nodeCount;
+    add(n, label, false, lawler ? nullptr : members);
+}
+
+void OutputWriter::cluster(const Node* root, const std::vector<Node*>& members){
+    add(root, 0, true, &members);
+}
+
+void OutputWriter::add(const Node* n, int label, bool isCluster, const std::vector<Node*>* members){
+    Record r = {n, label, isCluster, filling.memberPool.size(), 0};
+    if (members != nullptr){
+        r.memberCount = members->size();
+        filling.memberPool.insert(filling.memberPool.end(), members->begin(), members->end());
+    }
+    filling.records.push_back(r);
+    if (filling.records.size() >= OUTPUT_BATCH_RECORDS) handOver(false);
+}
+
+void OutputWriter::handOver(bool last){
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        //a writer that falls behind holds the producer back to one batch in flight, so memory stays bounded
+        wake.wait(guard, [this](){ return queued.records.empty(); });
+        std::swap(queued, filling);
+        if (last) done = true;
+    }
+    wake.notify_all();
+    filling.records.clear();
+    filling.memberPool.clear();
+}
+
+void OutputWriter::writerLoop(){
+    Batch batch;
+    while (true){
+        bool last;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [this](){ return !queued.records.empty() || done; });
+            std::swap(batch, queued);
+            last = done;
+        }
+        wake.notify_all();
+        writeBatch(batch);
+        batch.records.clear();
+        batch.memberPool.clear();
+        if (last) break;
+    }
+    resultTable.close();
+    if (!clusterSection) writeClusterSectionHeader(verboseResult);
+    verboseResult.close();
+    clustrTable.close();
+}
+
+void OutputWriter::writeBatch(Batch& batch){
+    for (auto& r : batch.records){
+        Node* const* members = batch.memberPool.data() + r.firstMember;
+        if (!r.isCluster){
+            writeNodeRow(resultTable, verboseResult, r.node, r.label, members, r.memberCount, lawler, tooLargeForTable);
+            continue;
+        }
+        if (!clusterSection){
+            writeClusterSectionHeader(verboseResult);
+            clusterSection = true;
+        }
+        writeClusterRow(clustrTable, verboseResult, r.node, members, r.memberCount, tooLargeForTable);
+    }
+}
+
+void OutputWriter::finish(){
+    if (!thread.joinable()) return;
+    handOver(true);
+    thread.join();
+}
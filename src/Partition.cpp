@@ -0,0 +1,285 @@
+//
+// Partitioned RW labeling: worker processes label a netlist through a POSIX shared memory segment
+//
+
+#include "../include/Partition.h"
+#include "../include/common.h"
+#include "../include/Metrics.h"
+#include "../include/Progress.h"
+#include "../include/TaskPool.h"
+#include "../include/Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <new>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define PARTITION_CHUNKS_PER_PROCESS 16 //claims per worker and level, smaller chunks balance better
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "shared memory counters must be lock free to work across processes");
+
+//Start of the shared segment, followed by the arrays laid out in SharedLayout
+struct SharedHeader {
+    pthread_barrier_t barrier;
+    std::atomic<uint64_t> labeled;         //nodes labeled so far, for the progress line
+    std::atomic<int> completedLevels;      //every level below this one is labeled
+};
+
+struct SharedLayout {
+    size_t claimedOffset;   //std::atomic<uint32_t>[levels]: next unclaimed position in each level
+    size_t labelsOffset;    //int[N]
+    size_t countOffset;     //uint32_t[N]: cluster size of each node
+    size_t membersOffset;   //uint32_t[N * slots]: cluster member ids
+    size_t bytes;
+    int slots;
+
+    SharedLayout(size_t N, size_t levels, int maxClusterSize){
+        slots = (maxClusterSize > 1) ? maxClusterSize : 1;
+        claimedOffset = (sizeof(SharedHeader) + 63) / 64 * 64;
+        labelsOffset = claimedOffset + levels * sizeof(std::atomic<uint32_t>);
+        countOffset = labelsOffset + N * sizeof(int);
+        membersOffset = countOffset + N * sizeof(uint32_t);
+        bytes = membersOffset + N * slots * sizeof(uint32_t);
+    }
+};
+
+struct SharedSegment {
+    char* base;
+    SharedLayout layout;
+    SharedHeader* header() { return (SharedHeader*) base; }
+    std::atomic<uint32_t>* claimed() { return (std::atomic<uint32_t>*) (base + layout.claimedOffset); }
+    int* labels() { return (int*) (base + layout.labelsOffset); }
+    uint32_t* counts() { return (uint32_t*) (base + layout.countOffset); }
+    uint32_t* members(uint32_t id) { return (uint32_t*) (base + layout.membersOffset) + (size_t) id * layout.slots; }
+};
+
+static char* mapSharedSegment(size_t bytes, std::string& error){
+    //the name is removed right away: the mapping is inherited by fork and nothing is left behind on a crash
+    std::string name = "/rw_partition_" + std::to_string(getpid());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0){
+        error = "cannot create shared memory segment " + name;
+        return nullptr;
+    }
+    shm_unlink(name.c_str());
+    if (ftruncate(fd, bytes) != 0){
+        close(fd);
+        error = "cannot size shared memory segment (" + std::to_string(bytes) + " bytes)";
+        return nullptr;
+    }
+    void* base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED){
+        error = "cannot map shared memory segment (" + std::to_string(bytes) + " bytes)";
+        return nullptr;
+    }
+    return (char*) base;
+}
+
+int partitionProcessCount(int requested){
+    //Description: 0 = one worker process per core
+    return labelThreadCount(requested);
+}
+
+static void runWorker(std::vector<Node*>& master, DelayData& dd, LabelingOptions& opts, std::vector<int>& labels,
+                      std::vector<uint32_t>& byLevel, std::vector<size_t>& levelStart, int processes, SharedSegment& seg){
+    //the coordinator decides what happens on Ctrl-C; profiling data of a worker would be lost anyway
+    std::signal(SIGINT, SIG_IGN);
+    TRACE.enabled = false;
+    METRICS.enabled = false;
+    PROGRESS.enabled = false;
+    SharedHeader* hdr = seg.header();
+    int* sharedLabels = seg.labels();
+    LabelScratch scratch;
+    scratch.resize(labels.size());
+    size_t levels = levelStart.size() - 1;
+    for (size_t k = 0; k < levels; ++k){
+        if (k > 0){
+            if (pthread_barrier_wait(&hdr->barrier) == PTHREAD_BARRIER_SERIAL_THREAD){
+                hdr->completedLevels.store(k);
+            }
+            //the labels of the level every worker just finished
+            for (size_t i = levelStart[k - 1]; i < levelStart[k]; ++i){
+                labels[byLevel[i]] = sharedLabels[byLevel[i]];
+            }
+        }
+        uint32_t size = levelStart[k + 1] - levelStart[k];
+        uint32_t chunk = size / (processes * PARTITION_CHUNKS_PER_PROCESS);
+        if (chunk < 1) chunk = 1;
+        while (true){
+            uint32_t begin = seg.claimed()[k].fetch_add(chunk);
+            if (begin >= size) break;
+            uint32_t end = std::min(size, begin + chunk);
+            for (uint32_t j = begin; j < end; ++j){
+                Node* v = master[byLevel[levelStart[k] + j]];
+                Cluster cl(v->id);
+                labelNodeRW(v, master, dd, opts, labels, scratch, cl);
+                sharedLabels[v->id] = labels[v->id];
+                seg.counts()[v->id] = cl.members.size();
+                uint32_t* slot = seg.members(v->id);
+                for (auto mem : cl.members){
+                    *slot++ = mem->id;
+                }
+            }
+            hdr->labeled.fetch_add(end - begin);
+        }
+    }
+}
+
+//stops the workers that are still running and reaps every one of them
+static void stopWorkers(std::vector<pid_t>& pids){
+    for (auto pid : pids){
+        if (pid > 0) kill(pid, SIGKILL);
+    }
+    for (auto& pid : pids){
+        if (pid > 0){
+            while (waitpid(pid, nullptr, 0) < 0 && errno == EINTR);
+            pid = 0;
+        }
+    }
+}
+
+static std::string describeExit(int w, int status){
+    if (WIFSIGNALED(status)){
+        return "labeling worker " + std::to_string(w) + " was killed by signal " + std::to_string(WTERMSIG(status));
+    }
+    return "labeling worker " + std::to_string(w) + " exited with status " + std::to_string(WEXITSTATUS(status));
+}
+
+bool computeLabelsPartitioned(std::vector<Node*>& master, DelayData& dd, LabelingOptions& opts, LabelingResult& res,
+                              int processes, PartitionStats& stats, std::string& error){
+    size_t N = res.labels.size();
+    //logic level of every node; the topological order puts every fan-in first
+    std::vector<int> level(N, 0);
+    int levels = 0;
+    for (auto v : master){
+        int l = 0;
+        for (auto u : v->prev){
+            l = std::max(l, level[u->id] + 1);
+        }
+        level[v->id] = l;
+        levels = std::max(levels, l + 1);
+    }
+    //nodes grouped by level, in topological order within a level
+    std::vector<size_t> levelStart(levels + 1, 0);
+    for (auto v : master){
+        ++levelStart[level[v->id] + 1];
+    }
+    for (int k = 0; k < levels; ++k){
+        stats.largestLevel = std::max(stats.largestLevel, levelStart[k + 1]);
+        levelStart[k + 1] += levelStart[k];
+    }
+    std::vector<uint32_t> byLevel(master.size());
+    std::vector<size_t> cursor(levelStart.begin(), levelStart.end() - 1);
+    for (auto v : master){
+        byLevel[cursor[level[v->id]]++] = v->id;
+    }
+    processes = std::max(1, std::min(processes, (int) std::max<size_t>(stats.largestLevel, 1)));
+    stats.processes = processes;
+    stats.levels = levels;
+
+    SharedSegment seg = {nullptr, SharedLayout(N, levels, opts.maxClusterSize)};
+    seg.base = mapSharedSegment(seg.layout.bytes, error);
+    if (seg.base == nullptr) return false;
+    SharedHeader* hdr = new (seg.base) SharedHeader;
+    hdr->labeled.store(0);
+    hdr->completedLevels.store(0);
+    for (int k = 0; k < levels; ++k){
+        new (&seg.claimed()[k]) std::atomic<uint32_t>(0);
+    }
+    std::copy(res.labels.begin(), res.labels.end(), seg.labels());
+    pthread_barrierattr_t attr;
+    pthread_barrierattr_init(&attr);
+    pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(&hdr->barrier, &attr, processes);
+    pthread_barrierattr_destroy(&attr);
+
+    TraceSpan span("partitioned_labeling", "labeling");
+    std::vector<pid_t> pids(processes, 0);
+    bool ok = true;
+    for (int w = 0; w < processes; ++w){
+        pid_t pid = fork();
+        if (pid == 0){
+            int status = 0;
+            try {
+                runWorker(master, dd, opts, res.labels, byLevel, levelStart, processes, seg);
+            }
+            catch (...) {
+                status = 1;
+            }
+            _exit(status);
+        }
+        if (pid < 0){
+            error = "cannot start labeling worker " + std::to_string(w);
+            ok = false;
+            break;
+        }
+        pids[w] = pid;
+    }
+
+    //coordinator: wait for the workers, stop them all as soon as one fails or on Ctrl-C
+    ProgressMeter progress("labeling", "nodes", master.size());
+    int running = ok ? processes : 0;
+    bool interrupted = false;
+    while (running > 0){
+        bool reaped = false;
+        for (int w = 0; w < processes && ok; ++w){
+            int status = 0;
+            if (pids[w] <= 0 || waitpid(pids[w], &status, WNOHANG) <= 0) continue;
+            pids[w] = 0;
+            --running;
+            reaped = true;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0){
+                error = describeExit(w, status);
+                ok = false;
+            }
+        }
+        if (!ok) break;
+        if (interruptRequested()){
+            interrupted = true;
+            break;
+        }
+        progress.update(hdr->labeled.load());
+        if (!reaped) usleep(1000);
+    }
+    stopWorkers(pids);
+    progress.finish(hdr->labeled.load());
+    pthread_barrier_destroy(&hdr->barrier);
+
+    if (ok){
+        //merge in topological order; an interrupted run keeps the levels every worker had finished
+        int completed = interrupted ? hdr->completedLevels.load() : levels;
+        res.clusters.clear();
+        res.clusters.reserve(master.size());
+        res.maxLabel = 0;
+        res.maxIODelay = 0;
+        res.labeledNodes = 0;
+        for (auto v : master){
+            Cluster cl(v->id);
+            if (level[v->id] < completed){
+                res.labels[v->id] = seg.labels()[v->id];
+                uint32_t* slot = seg.members(v->id);
+                for (uint32_t m = 0; m < seg.counts()[v->id]; ++m){
+                    cl.members.push_back(master[slot[m]]);
+                }
+                generateInputSet(cl);
+                res.maxLabel = std::max(res.maxLabel, res.labels[v->id]);
+                ++res.labeledNodes;
+            }
+            res.clusters.push_back(cl);
+        }
+        res.interrupted = (completed < levels);
+    }
+    munmap(seg.base, seg.layout.bytes);
+    if (span.active()){
+        span.arg("processes", processes);
+        span.arg("levels", levels);
+    }
+    return ok;
+}
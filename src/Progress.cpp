@@ -0,0 +1,97 @@
+//
+// Live progress of the long running loops (delay matrix, labeling, clustering) and SIGINT handling
+//
+
+#include "../include/Progress.h"
+#include <cstdio>
+#include <unistd.h>
+
+ProgressSettings PROGRESS;
+volatile std::sig_atomic_t INTERRUPT_FLAG = 0;
+
+static void onInterrupt(int){
+    INTERRUPT_FLAG = 1;
+    std::signal(SIGINT, SIG_DFL);
+}
+
+void installInterruptHandler(){
+    std::signal(SIGINT, onInterrupt);
+}
+
+void requestInterrupt(){
+    INTERRUPT_FLAG = 1;
+}
+
+void clearInterrupt(){
+    INTERRUPT_FLAG = 0;
+}
+
+static void formatDuration(char* buf, size_t len, double seconds){
+    long long s = (long long) (seconds + 0.5);
+    if (s >= 3600) snprintf(buf, len, "%lldh%02lldm", s / 3600, (s / 60) % 60);
+    else if (s >= 60) snprintf(buf, len, "%lldm%02llds", s / 60, s % 60);
+    else snprintf(buf, len, "%.1fs", seconds);
+}
+
+ProgressMeter::ProgressMeter(const char* phase, const char* unit, uint64_t total, uint64_t totalWork){
+    on = PROGRESS.enabled;
+    printed = false;
+    tty = isatty(fileno(stderr));
+    this->phase = phase;
+    this->unit = unit;
+    this->total = total;
+    this->totalWork = totalWork;
+    stride = 1;
+    countdown = 1;
+    start = Clock::now();
+    lastCheck = start;
+    lastPrint = start;
+}
+
+void ProgressMeter::finish(uint64_t done){
+    if (on && printed) print(done, 0, true);
+    on = false;
+}
+
+void ProgressMeter::tick(uint64_t done, uint64_t work){
+    //aim for about 20 clock reads per interval
+    Clock::time_point now = Clock::now();
+    long long sinceCheck = std::chrono::duration_cast<std::chrono::microseconds>(now - lastCheck).count();
+    long long target = PROGRESS.intervalMs * 50;
+    if (sinceCheck < target / 2 && stride < (1u << 20)) stride *= 2;
+    else if (sinceCheck > target * 2 && stride > 1) stride /= 2;
+    countdown = stride;
+    lastCheck = now;
+    if (std::chrono::duration_cast<std::chrono::milliseconds>(now - lastPrint).count() < PROGRESS.intervalMs) return;
+    lastPrint = now;
+    print(done, work, false);
+}
+
+void ProgressMeter::print(uint64_t done, uint64_t work, bool last){
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    double rate = (elapsed > 0) ? done / elapsed : 0;
+    char elapsedStr[32];
+    formatDuration(elapsedStr, sizeof(elapsedStr), elapsed);
+    char line[256];
+    if (last){
+        snprintf(line, sizeof(line), "[%s] %llu %s in %s (%.0f %s/s)", phase,
+                 (unsigned long long) done, unit, elapsedStr, rate, unit);
+    }
+    else {
+        //remaining time from the share of the work done so far
+        uint64_t all = totalWork ? totalWork : total;
+        uint64_t finished = totalWork ? work : done;
+        char etaStr[32] = "?";
+        if (finished > 0 && all >= finished){
+            formatDuration(etaStr, sizeof(etaStr), elapsed * (all - finished) / finished);
+        }
+        double percent = (all > 0) ? 100.0 * finished / all : 0;
+        snprintf(line, sizeof(line), "[%s] %llu/%llu %s (%.1f%%), %.0f %s/s, elapsed %s, ETA %s", phase,
+                 (unsigned long long) done, (unsigned long long) total, unit, percent, rate, unit, elapsedStr, etaStr);
+    }
+    //a terminal gets one line that is redrawn in place
+    if (tty) fprintf(stderr, "\r%-100s%s", line, last ? "\n" : "");
+    else fprintf(stderr, "%s\n", line);
+    fflush(stderr);
+    printed = true;
+}
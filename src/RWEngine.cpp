@@ -0,0 +1,212 @@
+//
+// RWEngine: in-process interface to RW/Lawler labeling and clustering (librw)
+//
+
+#include "../include/RWEngine.h"
+#include "../include/common.h"
+#include <stdexcept>
+
+RWEngine::RWEngine(const RWOptions& opts){
+    setOptions(opts);
+}
+
+void RWEngine::setOptions(const RWOptions& opts){
+    this->opts = opts;
+    labelOpts.maxClusterSize = opts.maxClusterSize;
+    labelOpts.interClusterDelay = opts.interClusterDelay;
+    labelOpts.useLawler = opts.useLawler;
+    labelOpts.useExp = opts.useExp;
+    labelOpts.useExp2 = opts.useExp2;
+    labelOpts.useGui = opts.useGui;
+    labelOpts.labelThreads = opts.labelThreads;
+    labelOpts.parallelConeMin = opts.parallelConeMin;
+}
+
+void RWEngine::clear(){
+    rawNodeList.clear();
+    pending.clear();
+    POs.clear();
+    master.clear();
+    delayData.release();
+    res = LabelingResult();
+    tieRank.clear();
+    labelOpts.tieRank = nullptr;
+    error = "";
+}
+
+bool RWEngine::loadBLIF(const std::string& filename){
+    clear();
+    std::ifstream probe(filename);
+    if (!probe.is_open()){
+        error = "cannot open " + filename;
+        return false;
+    }
+    probe.close();
+    if (parseBLIF(filename, opts.piDelay, opts.poDelay, opts.nodeDelay, rawNodeList, error) != 0){
+        error += " in " + filename;
+        return false;
+    }
+    POs = obtainPONodes(rawNodeList);
+    if (rawNodeList.empty()){
+        error = "no nodes found in " + filename;
+        return false;
+    }
+    return true;
+}
+
+//the builder creates the same nodes, in the same order, as the first pass of parseBLIF
+void RWEngine::addInput(const std::string& name){
+    Node n(opts.piDelay);
+    n.isPI = true;
+    n.strID = name;
+    pending[name] = rawNodeList.size();
+    rawNodeList.push_back(n);
+}
+
+void RWEngine::addOutput(const std::string& name){
+    Node n(opts.poDelay);
+    n.isPO = true;
+    n.strID = name;
+    pending[name] = rawNodeList.size();
+    rawNodeList.push_back(n);
+}
+
+void RWEngine::addGate(const std::string& name, const std::vector<std::string>& fanins){
+    std::string line = ".names";
+    for (auto& f : fanins){
+        line += " " + f;
+    }
+    line += " " + name;
+    auto it = pending.find(name);
+    if (it != pending.end()){
+        rawNodeList[it->second].procStr = line; //already declared as an output
+        return;
+    }
+    Node n(opts.nodeDelay);
+    n.strID = name;
+    n.procStr = line;
+    pending[name] = rawNodeList.size();
+    rawNodeList.push_back(n);
+}
+
+void RWEngine::addLatch(const std::string& input, const std::string& output){
+    Node in(opts.poDelay);
+    in.strID = input + OUTPUT_LATCH_PREFIX;
+    in.isPO = true;
+    pending[in.strID] = rawNodeList.size();
+    rawNodeList.push_back(in);
+    Node out(opts.piDelay);
+    out.strID = output + INPUT_LATCH_PREFIX;
+    out.isPI = true;
+    pending[out.strID] = rawNodeList.size();
+    rawNodeList.push_back(out);
+}
+
+bool RWEngine::buildNetlist(){
+    //nodes may have moved while the list grew, so every link is rebuilt
+    for (auto& n : rawNodeList){
+        n.prev.clear();
+        n.next.clear();
+    }
+    master.clear();
+    res = LabelingResult();
+    if (linkBLIFNodes(rawNodeList, error) != 0){
+        return false;
+    }
+    POs = obtainPONodes(rawNodeList);
+    if (rawNodeList.empty()){
+        error = "empty netlist";
+        return false;
+    }
+    return true;
+}
+
+bool RWEngine::sortTopologically(){
+    master.clear();
+    for (auto& n : rawNodeList){
+        n.visited = false;
+    }
+    for (auto out : POs){ //recursively add all nodes to master in topological order
+        addPredecessors(master, out);
+    }
+    if (master.empty()){
+        error = "no primary outputs";
+        return false;
+    }
+    tieRank.clear();
+    if (opts.renumber){
+        renumberForLocality(master, POs, tieRank, locality);
+    }
+    labelOpts.tieRank = tieRank.empty() ? nullptr : tieRank.data();
+    return true;
+}
+
+void RWEngine::initializeLabels(){
+    //number the nodes in order for use in indexing the delay matrix and the per node arrays
+    uint32_t id = 0;
+    for (auto node : master){
+        node->id = id++;
+    }
+    ::initializeLabels(master, rawNodeList.size(), labelOpts, res);
+}
+
+int RWEngine::matrixMode(){
+    //Description: after sortTopologically; the unit delay fast path replaces the matrix when every gate has delay 1
+    if (opts.delayMode != DELAY_DENSE && opts.delayMode != DELAY_SPARSE) return DELAY_NONE;
+    if (opts.unitDelayFastPath && !opts.useLawler){
+        DelayData probe;
+        analyzeDelays(master, probe);
+        if (probe.unitDelay) return DELAY_NONE;
+    }
+    return opts.delayMode;
+}
+
+void RWEngine::computeDelays(){
+    int mode = opts.delayMode;
+    if (opts.useLawler && mode == DELAY_CONE){
+        mode = DELAY_NONE; //Lawler labeling has no use for cone delays
+    }
+    if (opts.unitDelayFastPath && !opts.useLawler && mode != DELAY_NONE){
+        //same delays as the matrix without building it; non-uniform delays fall back to the requested mode
+        prepareDelays(master, rawNodeList.size(), DELAY_UNIT, delayData);
+        if (delayData.mode == DELAY_UNIT) return;
+    }
+    prepareDelays(master, rawNodeList.size(), mode, delayData, opts.labelThreads);
+}
+
+void RWEngine::computeLabels(){
+    ::computeLabels(master, POs, delayData, labelOpts, res);
+    applyLabels(master, res);
+}
+
+void RWEngine::computeClusters(){
+    ::computeClusters(master, POs, labelOpts, res);
+    finalizeResult(labelOpts, res);
+}
+
+bool RWEngine::run(){
+    if (!sortTopologically()) return false;
+    initializeLabels();
+    computeDelays();
+    computeLabels();
+    computeClusters();
+    return true;
+}
+
+Node* RWEngine::findNode(const std::string& name) const{
+    for (auto n : master){
+        if (n->strID == name) return n;
+    }
+    return nullptr;
+}
+
+const Cluster& RWEngine::clusterOf(const Node* n) const{
+    //RW keeps one cluster per node (indexed by id); Lawler clusters are listed by root
+    if (!opts.useLawler) return res.clusters.at(n->id);
+    for (auto& cl : res.clusters){
+        for (auto m : cl.members){
+            if (m == n) return cl;
+        }
+    }
+    throw std::out_of_range("node " + n->strID + " is not in any cluster");
+}
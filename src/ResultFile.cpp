@@ -0,0 +1,359 @@
+//
+// Binary result file (.rwb) writer and memory mapped reader
+//
+
+#include "../include/ResultFile.h"
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static uint64_t alignUp(uint64_t offset){
+    return (offset + 7) & ~((uint64_t) 7);
+}
+
+static void writePadding(std::ofstream& out, uint64_t written, uint64_t target){
+    static const char zeros[8] = {0,0,0,0,0,0,0,0};
+    if (target > written){
+        out.write(zeros, target - written);
+    }
+}
+
+bool writeBinaryResultFile(std::string filename,
+                           std::vector<Node*>& topoNodeList,
+                           std::vector<Cluster>& clList,
+                           std::vector<Cluster*>& clListFinal,
+                           int& maxIODelay,
+                           int& cmdMaxClusterSize,
+                           int& cmdInterClusterDelay,
+                           int& cmdPiDelay,
+                           int& cmdPoDelay,
+                           int& cmdNodeDelay,
+                           int& cmdUseLawlerLabeling,
+                           int& cmdUseGui,
+                           int& cmdUseExp)
+{
+    //Description: writes every node, label and cluster (regardless of cluster size) into a single binary file
+    //returns false if the file could not be written completely
+    RWBHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, RWB_MAGIC, 4);
+    hdr.version = RWB_VERSION;
+    hdr.endianTag = RWB_ENDIAN_TAG;
+    hdr.headerSize = sizeof(RWBHeader);
+    hdr.flags = (cmdUseLawlerLabeling ? RWB_FLAG_LAWLER : 0) | (cmdUseGui ? RWB_FLAG_GUI : 0) | (cmdUseExp ? RWB_FLAG_EXP : 0);
+    hdr.maxClusterSize = cmdMaxClusterSize;
+    hdr.interClusterDelay = cmdInterClusterDelay;
+    hdr.piDelay = cmdPiDelay;
+    hdr.poDelay = cmdPoDelay;
+    hdr.nodeDelay = cmdNodeDelay;
+    hdr.maxIODelay = maxIODelay;
+
+    std::vector<RWBNode> nodes(topoNodeList.size());
+    uint64_t stringBytes = 0;
+    for (uint64_t i=0; i < topoNodeList.size(); ++i){
+        Node *n = topoNodeList.at(i);
+        memset(&nodes[i], 0, sizeof(RWBNode));
+        nodes[i].nameOffset = stringBytes;
+        nodes[i].nameLength = n->strID.length();
+        nodes[i].delay = n->delay;
+        nodes[i].label = n->label;
+        nodes[i].isPI = n->isPI;
+        nodes[i].isPO = n->isPO;
+        stringBytes += n->strID.length();
+    }
+
+    //clusters are referenced from the final list by their position in clList
+    std::vector<RWBCluster> clusters(clList.size());
+    std::vector<uint32_t> memberIds;
+    std::vector<uint32_t> inputIds;
+    for (uint64_t i=0; i < clList.size(); ++i){
+        Cluster& c = clList.at(i);
+        memset(&clusters[i], 0, sizeof(RWBCluster));
+        clusters[i].rootId = c.id;
+        clusters[i].memberCount = c.members.size();
+        clusters[i].inputCount = c.inputSet.size();
+        clusters[i].memberOffset = memberIds.size();
+        clusters[i].inputOffset = inputIds.size();
+        for (auto mem : c.members){
+            memberIds.push_back(mem->id);
+        }
+        for (auto in : c.inputSet){
+            inputIds.push_back(in->id);
+        }
+    }
+    std::vector<uint32_t> finalIdx;
+    for (auto cl : clListFinal){
+        finalIdx.push_back(cl - clList.data());
+    }
+
+    //name index and fan-in edges let readers pull out a neighbourhood without loading the whole graph
+    std::vector<uint32_t> nameIndex(topoNodeList.size());
+    for (uint32_t i=0; i < nameIndex.size(); ++i){
+        nameIndex[i] = i;
+    }
+    std::sort(nameIndex.begin(), nameIndex.end(), [&](uint32_t a, uint32_t b){
+        return topoNodeList[a]->strID < topoNodeList[b]->strID;
+    });
+    std::vector<uint64_t> faninIndex(topoNodeList.size() + 1, 0);
+    std::vector<uint32_t> faninIds;
+    for (uint64_t i=0; i < topoNodeList.size(); ++i){
+        faninIndex[i] = faninIds.size();
+        for (auto p : topoNodeList.at(i)->prev){
+            faninIds.push_back(p->id);
+        }
+    }
+    faninIndex[topoNodeList.size()] = faninIds.size();
+
+    hdr.nodeCount = nodes.size();
+    hdr.clusterCount = clusters.size();
+    hdr.finalCount = finalIdx.size();
+    hdr.memberCount = memberIds.size();
+    hdr.inputCount = inputIds.size();
+    hdr.stringBytes = stringBytes;
+    hdr.nodeOffset = alignUp(sizeof(RWBHeader));
+    hdr.clusterOffset = alignUp(hdr.nodeOffset + nodes.size()*sizeof(RWBNode));
+    hdr.finalOffset = alignUp(hdr.clusterOffset + clusters.size()*sizeof(RWBCluster));
+    hdr.memberOffset = alignUp(hdr.finalOffset + finalIdx.size()*sizeof(uint32_t));
+    hdr.inputOffset = alignUp(hdr.memberOffset + memberIds.size()*sizeof(uint32_t));
+    hdr.stringOffset = alignUp(hdr.inputOffset + inputIds.size()*sizeof(uint32_t));
+    hdr.faninCount = faninIds.size();
+    hdr.nameIndexOffset = alignUp(hdr.stringOffset + stringBytes);
+    hdr.faninIndexOffset = alignUp(hdr.nameIndexOffset + nameIndex.size()*sizeof(uint32_t));
+    hdr.faninOffset = alignUp(hdr.faninIndexOffset + faninIndex.size()*sizeof(uint64_t));
+    hdr.fileSize = hdr.faninOffset + faninIds.size()*sizeof(uint32_t);
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    uint64_t pos = 0;
+    out.write((const char*) &hdr, sizeof(hdr));
+    pos += sizeof(hdr);
+    writePadding(out, pos, hdr.nodeOffset); pos = hdr.nodeOffset;
+    out.write((const char*) nodes.data(), nodes.size()*sizeof(RWBNode));
+    pos += nodes.size()*sizeof(RWBNode);
+    writePadding(out, pos, hdr.clusterOffset); pos = hdr.clusterOffset;
+    out.write((const char*) clusters.data(), clusters.size()*sizeof(RWBCluster));
+    pos += clusters.size()*sizeof(RWBCluster);
+    writePadding(out, pos, hdr.finalOffset); pos = hdr.finalOffset;
+    out.write((const char*) finalIdx.data(), finalIdx.size()*sizeof(uint32_t));
+    pos += finalIdx.size()*sizeof(uint32_t);
+    writePadding(out, pos, hdr.memberOffset); pos = hdr.memberOffset;
+    out.write((const char*) memberIds.data(), memberIds.size()*sizeof(uint32_t));
+    pos += memberIds.size()*sizeof(uint32_t);
+    writePadding(out, pos, hdr.inputOffset); pos = hdr.inputOffset;
+    out.write((const char*) inputIds.data(), inputIds.size()*sizeof(uint32_t));
+    pos += inputIds.size()*sizeof(uint32_t);
+    writePadding(out, pos, hdr.stringOffset); pos = hdr.stringOffset;
+    for (auto n : topoNodeList){
+        out.write(n->strID.data(), n->strID.length());
+    }
+    pos += stringBytes;
+    writePadding(out, pos, hdr.nameIndexOffset); pos = hdr.nameIndexOffset;
+    out.write((const char*) nameIndex.data(), nameIndex.size()*sizeof(uint32_t));
+    pos += nameIndex.size()*sizeof(uint32_t);
+    writePadding(out, pos, hdr.faninIndexOffset); pos = hdr.faninIndexOffset;
+    out.write((const char*) faninIndex.data(), faninIndex.size()*sizeof(uint64_t));
+    pos += faninIndex.size()*sizeof(uint64_t);
+    writePadding(out, pos, hdr.faninOffset);
+    out.write((const char*) faninIds.data(), faninIds.size()*sizeof(uint32_t));
+    out.close();
+    if (!out) return false;
+    return true;
+}
+
+ResultFileReader::ResultFileReader(){
+    fd = -1;
+    base = nullptr;
+    length = 0;
+}
+
+ResultFileReader::~ResultFileReader(){
+    close();
+}
+
+bool ResultFileReader::open(std::string filename){
+    close();
+    error = "";
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0){
+        error = "cannot open " + filename;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < RWB_V1_HEADER_SIZE){
+        error = "file too small to be a result file";
+        close();
+        return false;
+    }
+    length = st.st_size;
+    void *map = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED){
+        error = "mmap failed";
+        length = 0;
+        close();
+        return false;
+    }
+    base = (const char*) map;
+
+    //the fields both versions share come first
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(&hdr, base, offsetof(RWBHeader, faninCount));
+    if (memcmp(hdr.magic, RWB_MAGIC, 4) != 0){
+        error = "bad magic";
+    }
+    else if (hdr.endianTag != RWB_ENDIAN_TAG){
+        error = "file was written with a different byte order";
+    }
+    else if (hdr.version == RWB_VERSION && hdr.headerSize == sizeof(RWBHeader) && length >= sizeof(RWBHeader)){
+        memcpy(&hdr, base, sizeof(RWBHeader));
+    }
+    else if (hdr.version == RWB_VERSION_NO_GRAPH && hdr.headerSize == RWB_V1_HEADER_SIZE){
+        memcpy(&hdr.fileSize, base + offsetof(RWBHeader, faninCount), sizeof(hdr.fileSize));
+    }
+    else {
+        error = "unsupported result file version " + std::to_string(hdr.version);
+    }
+    if (error.empty() && hdr.fileSize != length){
+        error = "truncated result file";
+    }
+    if (error.empty()){
+        validate();
+    }
+    if (!error.empty()){
+        close();
+        return false;
+    }
+    return true;
+}
+
+//true if count elements of width bytes starting at offset lie inside the mapping (8 byte aligned)
+bool ResultFileReader::fits(uint64_t offset, uint64_t count, uint64_t width) const {
+    return offset % 8 == 0 && offset <= length && count <= (length - offset) / width;
+}
+
+void ResultFileReader::validate(){
+    //Description: every accessor indexes the mapping with offsets and ids taken from the file, so all of them
+    //are checked once here; a file that passes can be read without going out of bounds
+    uint64_t N = hdr.nodeCount;
+    if (!fits(hdr.nodeOffset, N, sizeof(RWBNode)) || !fits(hdr.clusterOffset, hdr.clusterCount, sizeof(RWBCluster)) ||
+        !fits(hdr.finalOffset, hdr.finalCount, sizeof(uint32_t)) || !fits(hdr.memberOffset, hdr.memberCount, sizeof(uint32_t)) ||
+        !fits(hdr.inputOffset, hdr.inputCount, sizeof(uint32_t)) || !fits(hdr.stringOffset, hdr.stringBytes, 1)){
+        error = "section out of range";
+        return;
+    }
+    if (hasGraph() && (!fits(hdr.nameIndexOffset, N, sizeof(uint32_t)) || N == UINT64_MAX ||
+        !fits(hdr.faninIndexOffset, N + 1, sizeof(uint64_t)) || !fits(hdr.faninOffset, hdr.faninCount, sizeof(uint32_t)))){
+        error = "section out of range";
+        return;
+    }
+    if (!(hdr.flags & RWB_FLAG_LAWLER) && hdr.clusterCount < N){
+        //RW files keep one cluster per node, and readers look it up by node id
+        error = "cluster table shorter than node table";
+        return;
+    }
+    auto idsBelow = [&](uint64_t offset, uint64_t count, uint64_t limit){
+        const uint32_t *ids = section<uint32_t>(offset);
+        for (uint64_t i=0; i < count; ++i){
+            if (ids[i] >= limit) return false;
+        }
+        return true;
+    };
+    for (uint64_t i=0; i < N; ++i){
+        const RWBNode& n = node(i);
+        if (n.nameOffset > hdr.stringBytes || n.nameLength > hdr.stringBytes - n.nameOffset){
+            error = "node name out of range";
+            return;
+        }
+    }
+    for (uint64_t i=0; i < hdr.clusterCount; ++i){
+        const RWBCluster& c = cluster(i);
+        if (c.rootId >= N || c.memberOffset > hdr.memberCount || c.memberCount > hdr.memberCount - c.memberOffset ||
+            c.inputOffset > hdr.inputCount || c.inputCount > hdr.inputCount - c.inputOffset){
+            error = "cluster out of range";
+            return;
+        }
+    }
+    if (!idsBelow(hdr.finalOffset, hdr.finalCount, hdr.clusterCount)){
+        error = "final cluster out of range";
+        return;
+    }
+    if (!idsBelow(hdr.memberOffset, hdr.memberCount, N) || !idsBelow(hdr.inputOffset, hdr.inputCount, N)){
+        error = "node id out of range";
+        return;
+    }
+    if (!hasGraph()) return;
+    const uint64_t *faninIndex = section<uint64_t>(hdr.faninIndexOffset);
+    for (uint64_t i=0; i < N; ++i){
+        if (faninIndex[i] > faninIndex[i+1]){
+            error = "fan-in index out of order";
+            return;
+        }
+    }
+    if (faninIndex[0] != 0 || faninIndex[N] != hdr.faninCount){
+        error = "fan-in index out of range";
+    }
+    else if (!idsBelow(hdr.nameIndexOffset, N, N) || !idsBelow(hdr.faninOffset, hdr.faninCount, N)){
+        error = "node id out of range";
+    }
+}
+
+void ResultFileReader::close(){
+    if (base != nullptr){
+        munmap((void*) base, length);
+        base = nullptr;
+    }
+    if (fd >= 0){
+        ::close(fd);
+        fd = -1;
+    }
+    length = 0;
+}
+
+std::string ResultFileReader::nodeName(uint64_t id) const {
+    const RWBNode& n = node(id);
+    return std::string(section<char>(header().stringOffset) + n.nameOffset, n.nameLength);
+}
+
+uint64_t ResultFileReader::faninCount(uint64_t id) const {
+    if (!hasGraph()) return 0;
+    const uint64_t *index = section<uint64_t>(header().faninIndexOffset);
+    return index[id+1] - index[id];
+}
+
+const uint32_t* ResultFileReader::fanins(uint64_t id) const {
+    if (!hasGraph()) return nullptr;
+    return section<uint32_t>(header().faninOffset) + section<uint64_t>(header().faninIndexOffset)[id];
+}
+
+bool ResultFileReader::findNode(const std::string& name, uint32_t& id) const {
+    const char *strings = section<char>(header().stringOffset);
+    if (!hasGraph()){
+        for (uint64_t i=0; i < nodeCount(); ++i){
+            const RWBNode& n = node(i);
+            if (name.compare(0, std::string::npos, strings + n.nameOffset, n.nameLength) == 0){
+                id = i;
+                return true;
+            }
+        }
+        return false;
+    }
+    const uint32_t *index = section<uint32_t>(header().nameIndexOffset);
+    uint64_t lo = 0;
+    uint64_t hi = nodeCount();
+    while (lo < hi){
+        uint64_t mid = lo + (hi - lo) / 2;
+        const RWBNode& n = node(index[mid]);
+        int cmp = name.compare(0, std::string::npos, strings + n.nameOffset, n.nameLength);
+        if (cmp == 0){
+            id = index[mid];
+            return true;
+        }
+        if (cmp < 0) hi = mid;
+        else lo = mid + 1;
+    }
+    return false;
+}
@@ -0,0 +1,175 @@
+//
+// In-process parameter sweep over max cluster size / inter cluster delay
+//
+
+#include "../include/Sweep.h"
+#include "../include/Trace.h"
+#include "../include/Progress.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace sc = std::chrono;
+
+std::vector<int> parseIntList(std::string str){
+    //Description: parses a comma separated list of integers ("4,8,16")
+    std::vector<int> result;
+    std::stringstream ss(str);
+    std::string item;
+    while (std::getline(ss, item, ',')){
+        if (item != ""){
+            result.push_back(std::atoi(item.c_str()));
+        }
+    }
+    return result;
+}
+
+std::vector<SweepPoint> buildSweepPoints(std::vector<int>& sizes, std::vector<int>& delays,
+                                         bool includeRW, bool includeLawler, bool includeExp){
+    std::vector<SweepPoint> points;
+    for (auto s : sizes){
+        for (auto c : delays){
+            SweepPoint p;
+            p.opts.maxClusterSize = s;
+            p.opts.interClusterDelay = c;
+            p.opts.useLawler = false;
+            p.opts.useExp = false;
+            p.opts.useExp2 = false;
+            p.opts.useGui = false;
+            if (includeRW){
+                points.push_back(p);
+            }
+            if (includeExp){
+                p.opts.useExp = true;
+                points.push_back(p);
+                p.opts.useExp = false;
+            }
+            if (includeLawler){
+                p.opts.useLawler = true;
+                points.push_back(p);
+            }
+        }
+    }
+    return points;
+}
+
+static long long availableMemoryBytes(){
+    //only works on linux; returns -1 if unknown
+    FILE* file = fopen("/proc/meminfo", "r");
+    if (file == NULL) return -1;
+    long long result = -1;
+    char line[128];
+    while (fgets(line, 128, file) != NULL){
+        if (strncmp(line, "MemAvailable:", 13) == 0){
+            long long kb = 0;
+            sscanf(line + 13, "%lld", &kb);
+            result = kb * 1024;
+            break;
+        }
+    }
+    fclose(file);
+    return result;
+}
+
+int sweepWorkerCount(int requested, int N, std::vector<SweepPoint>& points){
+    //Description: number of concurrent runs; bounded by cores, sweep size and the memory a run needs
+    int jobs = requested;
+    if (jobs <= 0){
+        jobs = std::thread::hardware_concurrency();
+        if (jobs <= 0) jobs = 1;
+        //estimate the footprint of the largest run: per node arrays + one cluster (members and inputs) per node
+        int maxSize = 1;
+        for (auto& p : points){
+            maxSize = (p.opts.maxClusterSize > maxSize) ? p.opts.maxClusterSize : maxSize;
+        }
+        long long perRun = (long long) N * (16 + sizeof(Cluster) + 24 * (long long) maxSize);
+        long long avail = availableMemoryBytes();
+        if (avail > 0 && perRun > 0){
+            long long fit = (avail * 8 / 10) / perRun;
+            if (fit < jobs) jobs = (fit < 1) ? 1 : (int) fit;
+        }
+    }
+    if (jobs > (int) points.size()) jobs = points.size();
+    return (jobs < 1) ? 1 : jobs;
+}
+
+void runSweep(std::vector<Node*>& master, std::vector<Node*>& POs, int N, DelayData& dd,
+              std::vector<SweepPoint>& points, int jobs){
+    //Description: runs labeling and clustering for every sweep point; the graph and delay data are shared read only
+    DelayData noMatrix;
+    prepareDelays(master, N, DELAY_NONE, noMatrix);
+    std::atomic<size_t> nextPoint(0);
+    auto worker = [&](){
+        while (true){
+            size_t i = nextPoint++;
+            if (i >= points.size()) break;
+            SweepPoint& p = points.at(i);
+            if (interruptRequested()) continue; //the point stays marked as not run
+            TraceSpan span("sweep_point", "sweep");
+            span.arg("max_cluster_size", p.opts.maxClusterSize);
+            span.arg("intercluster_delay", p.opts.interClusterDelay);
+            span.arg("mode", std::string(p.opts.useLawler ? "LAWLER" : (p.opts.useExp ? "RW EXP" : "RW")));
+            LabelingResult res;
+            auto labelStart = sc::high_resolution_clock::now();
+            initializeLabels(master, N, p.opts, res);
+            //delay matrix is never used for lawler labeling
+            computeLabels(master, POs, p.opts.useLawler ? noMatrix : dd, p.opts, res);
+            auto labelEnd = sc::high_resolution_clock::now();
+            computeClusters(master, POs, p.opts, res);
+            auto clusterEnd = sc::high_resolution_clock::now();
+            finalizeResult(p.opts, res);
+            if (res.interrupted) continue;
+
+            p.numClusters = res.finalClusterList.size();
+            p.maxIODelay = res.maxIODelay;
+            p.maxIODelayLawlerModified = res.maxIODelayLawlerModified;
+            p.clusterAreaCost = res.clusterAreaCost;
+            p.labelTimeUs = sc::duration_cast<sc::microseconds>(labelEnd - labelStart).count();
+            p.clusterTimeUs = sc::duration_cast<sc::microseconds>(clusterEnd - labelEnd).count();
+            p.completed = true;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t=1; t < jobs; ++t){
+        threads.push_back(std::thread([&worker, t](){
+            traceThreadName("sweep worker " + std::to_string(t));
+            worker();
+        }));
+    }
+    worker();
+    for (auto& t : threads){
+        t.join();
+    }
+}
+
+void writeSweepSummary(std::string filename, std::vector<SweepPoint>& points, SweepSharedTimes& shared, int N){
+    std::ofstream sweepFile;
+    sweepFile.open(filename);
+    sweepFile << "RUN MODE,MAX CLUSTER SIZE,INTER CLUSTER DELAY,NON-OVERLAP,NUMBER OF CLUSTERS,MAX IO PATH DELAY,"
+              << "MAX IO PATH DELAY (GENERAL DELAY MODEL),CLUSTERED AREA,AREA FACTOR,"
+              << "PARSING (us),TOPOLOGICAL SORTING (us),DELAY MATRIX (us),LABEL AND INITIAL CLUSTERING (us),CLUSTERING (us)" << std::endl;
+    for (auto& p : points){
+        if (!p.completed) continue; //interrupted runs
+        sweepFile << (p.opts.useLawler ? "LAWLER" : "RW") << ","
+                  << p.opts.maxClusterSize << ","
+                  << p.opts.interClusterDelay << ","
+                  << (p.opts.useExp ? "Y" : "N") << ","
+                  << p.numClusters << ","
+                  << p.maxIODelay << ","
+                  << (p.opts.useLawler ? p.maxIODelayLawlerModified : p.maxIODelay) << ","
+                  << p.clusterAreaCost << ","
+                  << ((float) p.clusterAreaCost)/((float) N) << ","
+                  << shared.parseUs << ","
+                  << shared.topoUs << ","
+                  << shared.delayMatrixUs << ","
+                  << p.labelTimeUs << ","
+                  << p.clusterTimeUs << std::endl;
+    }
+    sweepFile.close();
+}
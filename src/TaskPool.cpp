@@ -0,0 +1,120 @@
+//
+// Work-stealing task pool used to split the work on a single huge fan-in cone
+//
+
+#include "../include/TaskPool.h"
+#include "../include/Trace.h"
+#include <string>
+
+TaskPool::TaskPool(int threads){
+    if (threads < 1) threads = 1;
+    body = nullptr;
+    grain = 1;
+    pending = 0;
+    queued = 0;
+    stop = false;
+    for (int t=0; t < threads; ++t){
+        queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    }
+    for (int t=1; t < threads; ++t){
+        this->threads.push_back(std::thread([this, t](){
+            traceThreadName("label worker " + std::to_string(t));
+            workerLoop(t);
+        }));
+    }
+}
+
+TaskPool::~TaskPool(){
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads){
+        t.join();
+    }
+}
+
+void TaskPool::push(int self, Range r){
+    {
+        std::lock_guard<std::mutex> guard(queues[self]->lock);
+        queues[self]->ranges.push_back(r);
+    }
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        ++queued;
+    }
+    wake.notify_one();
+}
+
+bool TaskPool::take(int self, Range& r){
+    //own work first (most recently split, still warm in cache), then steal the oldest range of another worker
+    for (size_t i=0; i < queues.size(); ++i){
+        Queue& q = *queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> guard(q.lock);
+        if (q.ranges.empty()) continue;
+        if (i == 0){
+            r = q.ranges.back();
+            q.ranges.pop_back();
+        }
+        else {
+            r = q.ranges.front();
+            q.ranges.pop_front();
+        }
+        --queued;
+        return true;
+    }
+    return false;
+}
+
+void TaskPool::execute(int self, Range r){
+    //keep halving: the upper half becomes stealable, this worker continues on the lower half
+    while (r.hi - r.lo > grain){
+        size_t mid = r.lo + (r.hi - r.lo) / 2;
+        ++pending;
+        push(self, Range{mid, r.hi});
+        r.hi = mid;
+    }
+    (*body)(r.lo, r.hi);
+    --pending;
+}
+
+void TaskPool::workerLoop(int self){
+    while (true){
+        Range r;
+        if (take(self, r)){
+            execute(self, r);
+            continue;
+        }
+        std::unique_lock<std::mutex> guard(sleepLock);
+        wake.wait(guard, [this](){ return stop || queued > 0; });
+        if (stop) return;
+    }
+}
+
+void TaskPool::parallelFor(size_t begin, size_t end, size_t grain, const RangeBody& body){
+    if (begin >= end) return;
+    if (queues.size() == 1 || end - begin <= grain){
+        body(begin, end);
+        return;
+    }
+    this->body = &body;
+    this->grain = (grain < 1) ? 1 : grain;
+    pending = 1;
+    execute(0, Range{begin, end});
+    while (pending > 0){
+        Range r;
+        if (take(0, r)) execute(0, r);
+        else std::this_thread::yield();
+    }
+    this->body = nullptr;
+}
+
+int labelThreadCount(int requested){
+    //Description: 0 = one labeling thread per core
+    int threads = requested;
+    if (threads <= 0){
+        threads = std::thread::hardware_concurrency();
+    }
+    return (threads < 1) ? 1 : threads;
+}
@@ -0,0 +1,138 @@
+//
+// Timeline tracing in Chrome trace-event format (--trace out.json, open in chrome://tracing or Perfetto)
+//
+
+#include "../include/Trace.h"
+#include "../include/common.h"
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sc = std::chrono;
+
+TraceSettings TRACE;
+
+struct TraceEvent {
+    const char* name;
+    const char* cat;
+    char ph;            //'X' complete span, 'C' counter, 'M' metadata
+    long long tsNs;
+    long long durNs;
+    std::string args;   //JSON members without braces
+};
+
+//one buffer per thread so recording never takes a lock; buffers live until the trace is written
+struct TraceBuffer {
+    int tid;
+    std::vector<TraceEvent> events;
+};
+
+static const TraceTime traceOrigin = sc::high_resolution_clock::now();
+static std::mutex bufferLock;
+static std::vector<std::unique_ptr<TraceBuffer>> buffers;
+
+static TraceBuffer& threadBuffer(){
+    thread_local TraceBuffer* buffer = nullptr;
+    if (buffer == nullptr){
+        std::lock_guard<std::mutex> guard(bufferLock);
+        buffers.push_back(std::unique_ptr<TraceBuffer>(new TraceBuffer()));
+        buffer = buffers.back().get();
+        buffer->tid = buffers.size();
+    }
+    return *buffer;
+}
+
+static long long sinceOrigin(TraceTime t){
+    return sc::duration_cast<sc::nanoseconds>(t - traceOrigin).count();
+}
+
+static void pushEvent(const char* name, const char* cat, char ph, long long tsNs, long long durNs, std::string args){
+    TraceEvent e;
+    e.name = name;
+    e.cat = cat;
+    e.ph = ph;
+    e.tsNs = tsNs;
+    e.durNs = durNs;
+    e.args = args;
+    threadBuffer().events.push_back(e);
+}
+
+TraceSpan::TraceSpan(const char* name, const char* cat, bool sampled){
+    on = TRACE.enabled;
+    this->sampled = sampled;
+    this->name = name;
+    this->cat = cat;
+    if (on) start = sc::high_resolution_clock::now();
+}
+
+TraceSpan::~TraceSpan(){
+    if (!on) return;
+    TraceTime end = sc::high_resolution_clock::now();
+    long long durNs = sc::duration_cast<sc::nanoseconds>(end - start).count();
+    if (sampled){
+        thread_local long long sampleCount = 0;
+        bool keep = (sampleCount++ % TRACE.sampleRate == 0) || durNs >= TRACE.keepNs;
+        if (!keep) return;
+    }
+    pushEvent(name, cat, 'X', sinceOrigin(start), durNs, args);
+}
+
+void TraceSpan::arg(const char* key, long long value){
+    if (!on) return;
+    if (args != "") args += ",";
+    args += jsonString(key) + ":" + std::to_string(value);
+}
+
+void TraceSpan::arg(const char* key, const std::string& value){
+    if (!on) return;
+    if (args != "") args += ",";
+    args += jsonString(key) + ":" + jsonString(value);
+}
+
+void traceComplete(const char* name, const char* cat, TraceTime start, TraceTime end, std::string circuit){
+    if (!TRACE.enabled) return;
+    pushEvent(name, cat, 'X', sinceOrigin(start), sc::duration_cast<sc::nanoseconds>(end - start).count(),
+              "\"circuit\":" + jsonString(circuit));
+}
+
+void traceCounter(const char* name, long long value){
+    if (!TRACE.enabled) return;
+    pushEvent(name, "counter", 'C', sinceOrigin(sc::high_resolution_clock::now()), 0,
+              "\"value\":" + std::to_string(value));
+}
+
+void traceThreadName(std::string name){
+    if (!TRACE.enabled) return;
+    pushEvent("thread_name", "__metadata", 'M', 0, 0, "\"name\":" + jsonString(name));
+}
+
+static void writeMicroseconds(std::ofstream& out, long long ns){
+    //trace-event timestamps are microseconds; keep the nanosecond part as decimals
+    out << ns / 1000 << "." << (char) ('0' + (ns / 100) % 10) << (char) ('0' + (ns / 10) % 10) << (char) ('0' + ns % 10);
+}
+
+bool writeTraceFile(std::string filename){
+    std::ofstream out(filename);
+    if (!out.is_open()) return false;
+    std::lock_guard<std::mutex> guard(bufferLock);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (auto& buffer : buffers){
+        for (auto& e : buffer->events){
+            out << (first ? "\n" : ",\n");
+            first = false;
+            out << "{\"name\":" << jsonString(e.name) << ",\"cat\":" << jsonString(e.cat) << ",\"ph\":\"" << e.ph
+                << "\",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":";
+            writeMicroseconds(out, e.tsNs);
+            if (e.ph == 'X'){
+                out << ",\"dur\":";
+                writeMicroseconds(out, e.durNs);
+            }
+            out << ",\"args\":{" << e.args << "}}";
+        }
+    }
+    out << "\n]}\n";
+    out.close();
+    return true;
+}
@@ -18,8 +18,29 @@ FEATURES:   -Supports pure Rajaraman-Wong clustering with various runtime option
 #include "Cluster.h"
 #include "common.h"
 #include <algorithm>
+#include <cmath>
 #include <getopt.h>
 #include "SparseMatrix.h"
+#include "ResultFile.h"
+#include "Labeling.h"
+#include "Sweep.h"
+#include "Batch.h"
+#include "Eco.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include "MemoryStats.h"
+#include "RWEngine.h"
+#include "TaskPool.h"
+#include "Progress.h"
+#include "Checkpoint.h"
+#include "Partition.h"
+#include "LargeAlloc.h"
+#include "DelayCache.h"
+#include "OutputWriter.h"
+#include "Approximate.h"
+#include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
 
 namespace sc = std::chrono;
 
@@ -30,6 +51,8 @@ int PRIMARY_OUTPUT_DELAY = 1;
 int NODE_DELAY = 1;
 int USE_DELAY_MATRIX = true;
 int USE_SPARSE = true;
+int USE_UNIT_DELAY = true;
+int USE_HUGE_PAGES = true; //transparent huge page hint for the delay matrix (LargeAlloc.h)
 std::string FILENAME = "example_lecture.blif";
 int USE_LAWLER_LABELING = false;
 #if (defined(LINUX) || defined(__linux__))
@@ -40,625 +63,471 @@ int USE_LAWLER_LABELING = false;
 int USE_GUI = false;
 int USE_EXP = false;
 int USE_EXP2 = false; //RECOMMENDED AGAINST USING
+int USE_BINARY_OUTPUT = false;
+int RENUMBER = false; //replace the DFS topological order with a more local one when it is better
+std::string SWEEP_SIZES = "";
+std::string SWEEP_DELAYS = "";
+int NUM_JOBS = 0; //0 = pick from core count and available memory
+int LABEL_THREADS = 0; //0 = one per core
+int PARALLEL_CONE_MIN = 16384;
+int LABEL_PROCESSES = 1; //worker processes of partitioned labeling, 1 = label in this process
+std::string BATCH_PATH = "";
+std::string SAVE_STATE_FILE = "";
+std::string ECO_STATE_FILE = "";
+std::string ECO_DIFF_FILE = "";
+std::string METRICS_FILE = "";
+std::string TRACE_FILE = "";
+int MEM_REPORT = false;
+int FORCE_PROGRESS = false; //progress lines even when stderr is not a terminal
+int NO_PROGRESS = false;
+std::string CHECKPOINT_FILE = "";
+int CHECKPOINT_INTERVAL = 300; //seconds between two labeling checkpoints
+std::string RESUME_FILE = "";
+std::string DELAY_CACHE_DIR = ""; //directory of the persistent delay matrix caches
+int APPROX_CONE = 0; //candidates per node of approximate labeling, 0 = the whole cone
+double TIME_BUDGET = 0; //seconds of approximate labeling before the remaining nodes get no candidates
 
 std::string BLIFFile;
 
-void addPredecessors(std::vector<Node *>&, Node*);
-int max_delay(Node*, Node*, std::vector<Node*>);
-void lawler_cluster(std::vector<Node *>&, Node*, std::vector<Cluster>&);
-int main(int argc, char **argv) {
-
-    //parse arguments
-    int HELP_FLAG = 0;
-    const struct option longopts[] =
-    {
-        {"lawler", no_argument,     &USE_LAWLER_LABELING, 1},
-        {"no_matrix", no_argument, &USE_DELAY_MATRIX, 0},
-        {"no_sparse", no_argument, &USE_SPARSE, 0},
-        {"help", no_argument, nullptr, 'h'},
-        {"max_cluster_size", required_argument, nullptr, 's'},
-        {"pi_delay", required_argument, nullptr, 'i'},
-        {"po_delay", required_argument, nullptr, 'o'},
-        {"node_delay", required_argument, nullptr, 'n'},
-        {"intercluster_delay", required_argument, nullptr, 'c'},
-        {"gui",no_argument,&USE_GUI,1},
-        {"exp",no_argument,&USE_EXP,1},
-        {0,0,0,0}
-    };
-    int flag;
-    int option_index;
-    while(true){
-        flag = getopt_long(argc, argv, "s:i:o:n:c:", longopts, &option_index);
-        if(flag == -1) break;
-        switch(flag){
-            case 0:
-                break;
-            case 's':
-                MAX_CLUSTER_SIZE = std::atoi(optarg);
-                break;
-            case 'i':
-                PRIMARY_INPUT_DELAY = std::atoi(optarg);
-                break;
-            case 'o':
-                PRIMARY_OUTPUT_DELAY = std::atoi(optarg);
-                break;
-            case 'n':
-                NODE_DELAY = std::atoi(optarg);
-                break;
-            case 'c':
-                INTER_CLUSTER_DELAY = std::atoi(optarg);
-                break;
-            case 'h':
-                HELP_FLAG = 1;
-            case '?':
-                HELP_FLAG = 1;
-                break;
-            default:
-                std::cout << "Encountered error with command line arguments" << std::endl;
-                abort();
+//runs the whole flow (parse, sort, delay matrix, labeling, clustering, output files) for one netlist
+//quiet suppresses console output so several circuits can run side by side
+bool runCircuit(std::string blifFile, std::string circuitName, bool quiet, CircuitStats& stats){
+    std::ostream nullStream(nullptr);
+    std::ostream& out = quiet ? nullStream : std::cout;
+    TraceSpan circuitSpan("circuit", "run");
+    circuitSpan.arg("circuit", circuitName);
+    bool sampleMemory = MEM_REPORT || METRICS.enabled;
+    MemoryReport memReport;
+    int useGui = USE_GUI;
+    bool SWEEP_MODE = (SWEEP_SIZES != "" || SWEEP_DELAYS != "");
+
+    RWOptions engineOpts;
+    engineOpts.maxClusterSize = MAX_CLUSTER_SIZE;
+    engineOpts.interClusterDelay = INTER_CLUSTER_DELAY;
+    engineOpts.piDelay = PRIMARY_INPUT_DELAY;
+    engineOpts.poDelay = PRIMARY_OUTPUT_DELAY;
+    engineOpts.nodeDelay = NODE_DELAY;
+    //ECO mode takes delays from the fan-in cones it relabels, approximate labeling from its candidates
+    bool APPROX_MODE = (APPROX_CONE > 0 || TIME_BUDGET > 0);
+    bool noMatrix = !USE_DELAY_MATRIX || ECO_STATE_FILE != "" || APPROX_MODE;
+    engineOpts.delayMode = noMatrix ? DELAY_NONE : (USE_SPARSE ? DELAY_SPARSE : DELAY_DENSE);
+    engineOpts.unitDelayFastPath = USE_UNIT_DELAY;
+    //batch mode already keeps every core busy with whole circuits
+    engineOpts.labelThreads = (BATCH_PATH != "") ? 1 : LABEL_THREADS;
+    engineOpts.parallelConeMin = PARALLEL_CONE_MIN;
+    engineOpts.useLawler = USE_LAWLER_LABELING;
+    engineOpts.useExp = USE_EXP;
+    engineOpts.useExp2 = USE_EXP2;
+    engineOpts.renumber = RENUMBER;
+    RWEngine engine(engineOpts);
+    // REQUIREMENT: All arrays containing node objects MUST point to rawNodeList. No copies of Nodes may be made at any time.
+    std::vector<Node>& rawNodeList = engine.nodeList();
+    std::vector<Node *>& POs = engine.outputs();
+    std::vector<Node *>& master = engine.order();
+    DelayData& delayData = engine.delays();
+    LabelingOptions& labelOpts = engine.labelingOptions();
+    LabelingResult& result = engine.result();
+
+    bool ECO_MODE = (ECO_STATE_FILE != "");
+    EcoState ecoState;
+    EcoStats ecoStats;
+    ApproxStats approxStats;
+    if (ECO_MODE){
+        if (!loadEcoState(ECO_STATE_FILE, ecoState)){
+            out << "Error: cannot read saved state " << ECO_STATE_FILE << std::endl;
+            return false;
+        }
+        if (ecoState.maxClusterSize != MAX_CLUSTER_SIZE || ecoState.interClusterDelay != INTER_CLUSTER_DELAY ||
+            ecoState.piDelay != PRIMARY_INPUT_DELAY || ecoState.poDelay != PRIMARY_OUTPUT_DELAY || ecoState.nodeDelay != NODE_DELAY){
+            out << "Error: saved state was produced with different -s/-c/-i/-o/-n values, a full run is required" << std::endl;
+            return false;
         }
-    }
-    if (optind < argc) {
-        FILENAME = argv[optind];
-    }
-    if (HELP_FLAG) {
-        std::cout << "\nUsage: rw [arguments] [inputFile.blif]" << std::endl;
-        std::cout << "Options:" << std::endl;
-        std::cout << "-h, --help\t\tShow this help message and exit" << std::endl;
-        std::cout << "--lawler\t\tUse Lawler labeling algorithm instead of RW" << std::endl;
-        std::cout << "--no_matrix\t\tAvoid using a delay matrix, (pays a large runtime penalty at a large memory benefit)" << std::endl;
-        std::cout << "--no_sparse\t\tAvoid using a sparse matrix, (pays a large memory penalty at a small runtime benefit)" << std::endl;
-        std::cout << "--gui\t\tEnable interactive GUI (pays a runtime penalty for GUI file creation)" << std::endl;
-        std::cout << "--exp\t\tEnable non-overlap for clusters that are subsets of other clusters (pays runtime penalty)" << std::endl;
-        std::cout << "-s, --max_cluster_size\tSet max cluster size (default 8)" << std::endl;
-        std::cout << "-i, --pi_delay\t\tSet delay for all primary input nodes (default 0)" << std::endl;
-        std::cout << "-o, --po_delay\t\tSet delay for all primary output nodes (default 1)" << std::endl;
-        std::cout << "-n, --node_delay\t\tSet delay for all non-pi and non-po nodes (default 1)" << std::endl;
-        std::cout << "-c, --intercluster_delay\tSet intercluster delay (default 3)" << std::endl;
-
-        return 0;
-    }
-
-    if (UNIX_RUN){
-        BLIFFile = FILENAME;
-    }
-    else {
-        BLIFFile = "../" + FILENAME;
     }
 
-    if(USE_LAWLER_LABELING){
-        USE_DELAY_MATRIX = false;//delay matrix should not be calculated for lawler labeling
+    bool RESUME_MODE = (RESUME_FILE != "");
+    CheckpointState checkpointState;
+    if (RESUME_MODE){
+        if (!loadCheckpoint(RESUME_FILE, checkpointState)){
+            out << "Error: cannot read checkpoint " << RESUME_FILE << std::endl;
+            return false;
+        }
+        if (checkpointState.maxClusterSize != MAX_CLUSTER_SIZE || checkpointState.interClusterDelay != INTER_CLUSTER_DELAY ||
+            checkpointState.piDelay != PRIMARY_INPUT_DELAY || checkpointState.poDelay != PRIMARY_OUTPUT_DELAY ||
+            checkpointState.nodeDelay != NODE_DELAY || checkpointState.useLawler != USE_LAWLER_LABELING){
+            out << "Error: checkpoint was produced with different -s/-c/-i/-o/-n/--lawler values" << std::endl;
+            return false;
+        }
     }
 
-
-    /*
-    std::cout << "RWClustering Application" << "\nAuthors: Akshay Nagendra <akshaynag@gatech.edu>, Paul Yates <pyates6@gatech.edu>" << std::endl;
-    std::cout << "------------------------------------" << std::endl;
-    std::cout << "Input File: " << FILENAME.c_str() << std::endl;
-    std::cout << "Max Cluster Size = " << MAX_CLUSTER_SIZE << std::endl;
-    std::cout << "PI Node Delay = " << PRIMARY_INPUT_DELAY << std::endl;
-    std::cout << "PO Node Delay = " << PRIMARY_OUTPUT_DELAY << std::endl;
-    std::cout << "Normal Node Node Delay = " << NODE_DELAY << std::endl;
-    std::cout << "Inter Cluster Delay = " << INTER_CLUSTER_DELAY << std::endl;
-    if(USE_LAWLER_LABELING){
-        std::cout << "Using Lawler Labeling" << std::endl;
-    }
-    if(USE_DELAY_MATRIX) {
-        std::cout << "Using Delay Matrix" << std::endl;
+    auto parsestart = sc::high_resolution_clock::now();
+    if (ECO_MODE && ECO_DIFF_FILE != ""){
+        //the previous netlist comes from the saved state, only the diff is parsed
+        std::string error;
+        if (!buildNetlistFromDiff(ecoState, ECO_DIFF_FILE, PRIMARY_INPUT_DELAY, PRIMARY_OUTPUT_DELAY, NODE_DELAY, rawNodeList, POs, error)){
+            out << "Error: cannot apply " << ECO_DIFF_FILE << " to the saved state: " << error << std::endl;
+            stats.error = error;
+            return false;
+        }
     }
-    if (USE_GUI){
-        std::cout << "Interctive GUI: Enabled" << std::endl;
+    else if (!engine.loadBLIF(blifFile)){
+        out << "Error: " << engine.lastError() << std::endl;
+        stats.error = engine.lastError();
+        return false;
     }
-    else {
-        std::cout << "Interctive GUI: Disabled" << std::endl;
+    else if (ECO_MODE){
+        matchEcoNodes(ecoState, rawNodeList);
     }
-    */
-    std::vector<Node> rawNodeList;
-
-    auto parsestart = sc::high_resolution_clock::now();
-    parseBLIF(BLIFFile,PRIMARY_INPUT_DELAY,PRIMARY_OUTPUT_DELAY,NODE_DELAY,rawNodeList);
 
 
     //DEBUG
     /*
-    std::cout << "NODE ORDER: [";
+    out << "NODE ORDER: [";
     int idN = 0;
     for (std::vector<Node>::iterator iN = rawNodeList.begin(); iN < rawNodeList.end(); ++iN){
-        std::cout << iN->strID << "(" << idN << "),";
+        out << iN->strID << "(" << idN << "),";
         idN += 1;
     }
-    std::cout << "]" << std::endl;
+    out << "]" << std::endl;
      */
 
-    // REQUIREMENT: All arrays containing node objects MUST point to rawNodeList. No copies of Nodes may be made at any time.
-    std::vector<Node *> PIs = obtainPINodes(rawNodeList);
-    std::vector<Node *> POs = obtainPONodes(rawNodeList);
     auto parseEnd = sc::high_resolution_clock::now();
+    if (sampleMemory) memReport.sample("PARSING");
+    if (rawNodeList.empty()){
+        out << "Error: no nodes found in " << blifFile << std::endl;
+        return false;
+    }
 
-    std::cout << "Parsing and Population (PI & PO) Complete" << std::endl;
+    out << "Parsing and Population (PI & PO) Complete" << std::endl;
 
     int N = rawNodeList.size(); //the number of total nodes
 
-
-    std::vector<Node *> master;
     auto topoStart = sc::high_resolution_clock::now();
-    for(auto out : POs){ //recursively add all nodes to master in topological order
-        addPredecessors(master, out);
+    if (RESUME_MODE){
+        //the recorded order, so the restored labels keep their node ids
+        if (!restoreCheckpointOrder(checkpointState, rawNodeList, master)){
+            out << "Error: checkpoint " << RESUME_FILE << " was produced from a different netlist" << std::endl;
+            return false;
+        }
     }
-    auto topoEnd = sc::high_resolution_clock::now();
-
-    //DEBUG (SHOULD BE DELETED); JUST FOR CHECKING WITH MY HANDWRITTEN SOLUTION
-    /*master.clear();
-    int indices[12] = {0,1,2,5,6,7,8,9,10,11,3,4};
-    for (int i=0; i < 12; ++i){
-        master.push_back(&rawNodeList.at(indices[i]));
+    else {
+        engine.sortTopologically();
+        if (RENUMBER){
+            const LocalityStats& loc = engine.localityStats();
+            double saved = loc.before.sparseRowCells ?
+                100.0 * (1.0 - (double) loc.after.sparseRowCells / loc.before.sparseRowCells) : 0;
+            if (loc.applied){
+                out << "Renumbered for Locality: Mean Fan-in Distance " << loc.before.meanFaninDistance << " -> "
+                    << loc.after.meanFaninDistance << ", Sparse Row Cells " << loc.before.sparseRowCells << " -> "
+                    << loc.after.sparseRowCells << " (-" << (int) (saved + 0.5) << "%)" << std::endl;
+            }
+            else {
+                out << "Renumbered for Locality: DFS order kept (Mean Fan-in Distance " << loc.before.meanFaninDistance
+                    << ", Sparse Row Cells " << loc.before.sparseRowCells << ")" << std::endl;
+            }
+        }
     }
-    */
-
-    //number the nodes in order for use in indexing the delay_matrix array
+    auto topoEnd = sc::high_resolution_clock::now();
+    if (sampleMemory) memReport.sample("TOPOLOGICAL SORTING");
 
     auto labelInitialStart = sc::high_resolution_clock::now();
-    uint32_t id = 0;
-    for(auto node : master){
-        node->id = id++;
-        //apply initial labeling
-        if(!USE_LAWLER_LABELING){
-            if(node->isPI) {
-                node->label = node->delay; //For RW, PIs start at node delay
-            }
-        }
+    engine.initializeLabels();
+    if (RESUME_MODE){
+        restoreCheckpointLabels(checkpointState, master, result);
+        out << "Resuming From Checkpoint (" << result.labeledNodes << " of " << master.size() << " Nodes Labeled)" << std::endl;
     }
     auto labelInitialEnd = sc::high_resolution_clock::now();
+    if (sampleMemory) memReport.sample("LABEL INITIALIZATION");
 
     //Abort GUI if too large for GUI to handle or if using non-pure Rajaraman-Clustering
-    if (master.size() > GUI_NODE_CLUSTERSIZE_LIMIT || MAX_CLUSTER_SIZE > GUI_NODE_CLUSTERSIZE_LIMIT || USE_EXP2) {
-        USE_GUI = 0;
+    if (master.size() > GUI_NODE_CLUSTERSIZE_LIMIT || MAX_CLUSTER_SIZE > GUI_NODE_CLUSTERSIZE_LIMIT || USE_EXP2 || SWEEP_MODE) {
+        if (useGui && master.size() > GUI_NODE_CLUSTERSIZE_LIMIT) {
+            std::cout << "Circuit Too Large for the GUI, Use --binary and rwb_dump --gui for Cluster or Neighbourhood Views" << std::endl;
+        }
+        useGui = 0;
     }
+    labelOpts.useGui = useGui;
 
     //DEBUG
     /*
-    std::cout << "TOPOLOGICAL ORDER: [";
+    out << "TOPOLOGICAL ORDER: [";
     for (std::vector<Node*>::iterator iM = master.begin(); iM < master.end(); ++iM){
-        std::cout << (*iM)->strID << ",";
+        out << (*iM)->strID << ",";
     }
-    std::cout << "]" << std::endl;
+    out << "]" << std::endl;
     */
 
     auto delayMStart = sc::high_resolution_clock::now();
-    int* delay_matrix;
-    SparseMatrix sparse_delay_matrix(N,N);
-    if(USE_DELAY_MATRIX) {
-        //////     COMPUTE DELAY MATRIX //////
-        // delay_matrix[x][y] = max delay from output x to output y (node delay only)
-        if(!USE_SPARSE) {
-            delay_matrix = new int[N * N]; // Delay matrix is NxN square matrix.
+    bool delaysRestored = false;
+    if (RESUME_MODE && (engineOpts.delayMode == DELAY_DENSE || engineOpts.delayMode == DELAY_SPARSE)){
+        delaysRestored = loadDelayCheckpoint(RESUME_FILE + ".delays", N, delayData);
+    }
+    //the matrix only depends on the netlist, its delays and the order: a cached one is mapped instead of rebuilt
+    std::string delayCacheFile = "";
+    DelayCacheKey delayCacheKey;
+    bool delaysCached = false;
+    if (!delaysRestored && DELAY_CACHE_DIR != "" && engine.matrixMode() != DELAY_NONE){
+        delayCacheFile = DELAY_CACHE_DIR + "/" + circuitName + ".rwdc";
+        if (!makeDelayCacheKey(blifFile, master, N, PRIMARY_INPUT_DELAY, PRIMARY_OUTPUT_DELAY, NODE_DELAY,
+                               engine.matrixMode(), delayCacheKey)){
+            out << "Error: cannot read " << blifFile << " to check the delay cache" << std::endl;
+            delayCacheFile = "";
         }
-
-        //delay_matrix[N*r+c] (aka delay_matrix[r][c]) represents max delay from node r to node c
-        //the matrix entry = 0 if c precedes r in topological order
-        std::vector<Node *>::const_iterator r; //the node corresponding to the current matrix row
-        std::vector<Node *>::const_iterator c; // the node corresponding to the  current matrix column
-
-        for (r = master.begin(); r != master.end(); ++r) { // iterate across every row
-            //delay between a node and any previous node (and itself) is 0
-            if(!USE_SPARSE) {
-                for (c = master.begin(); c != r + 1; ++c) delay_matrix[N * (*r)->id + (*c)->id] = 0;
-            }
-            for (c = r + 1; c != master.end(); ++c) {
-                //max_delay(r,c) = max( max_delay(r, c->prev) )
-                int max = 0;
-                int prev_delay;
-                for (Node *p : (*c)->prev) {
-                    if(USE_SPARSE){
-                        prev_delay = sparse_delay_matrix.get((*r)->id, p->id);
-                    }
-                    else {
-                        prev_delay = delay_matrix[N * (*r)->id + p->id];
-                    }
-                    if (prev_delay > max) {
-                        max = prev_delay;
-                        //std::cout << "Found that " << (*c)->strID << "'s predecessor, " << (*p)->strID << ", has delay " << prev_delay << " to " << (*r)->strID << std::endl; //debug
-                    }
-                }
-                //if no predecessors of c have a delay to r, then either r is a direct predecessor, or there is no link
-                if (max == 0) {
-                    if(!USE_SPARSE) {
-                        delay_matrix[N * (*r)->id + (*c)->id] = 0;
-                    }
-                    for (Node *p2 : (*c)->prev) {
-                        if (p2->id == (*r)->id) {
-                            if(USE_SPARSE){
-                                sparse_delay_matrix.set((*r)->id,(*c)->id,(*c)->delay);
-                            }
-                            else {
-                                delay_matrix[N * (*r)->id + (*c)->id] = (*c)->delay;
-                            }
-                        }
-                    }
-                } else {
-                    if(USE_SPARSE){
-                        sparse_delay_matrix.set((*r)->id, (*c)->id, (*c)->delay + max);
-                    }
-                    else {
-                        delay_matrix[N * (*r)->id + (*c)->id] = (*c)->delay + max;
-                    }
-                }
-                //std::cout << "Delay from " << (*r)->strID << " to " << (*c)->strID << " is " << delay_matrix[N*(*r)->id+(*c)->id]<< std::endl; //debug
+        else {
+            std::string reason;
+            int status = loadDelayCache(delayCacheFile, delayCacheKey, delayData, reason);
+            delaysCached = (status == DELAY_CACHE_LOADED);
+            if (status == DELAY_CACHE_STALE || status == DELAY_CACHE_INVALID){
+                out << "Delay Cache " << delayCacheFile << " Not Used (" << reason << "), Rebuilding It" << std::endl;
             }
-
         }
-        std::cout << "Delay Matrix Calculation Complete" << std::endl;
     }
-    auto delayMEnd = sc::high_resolution_clock::now();
-
-    /*
-    // DEBUG
-    if(USE_DELAY_MATRIX) {
-        std::cout << "DELAY MATRIX:" << std::endl;
-        for (auto m : master) {
-            std::cout << "\t" << m->strID;
+    if (!delaysRestored && !delaysCached){
+        engine.computeDelays();
+    }
+    std::string interruptedPhase = "";
+    if (delaysRestored) {
+        out << "Delay Matrix Loaded From " << RESUME_FILE << ".delays" << std::endl;
+    }
+    else if (delaysCached) {
+        out << "Delay Matrix Mapped From Cache " << delayCacheFile << std::endl;
+    }
+    else if (interruptRequested()) {
+        out << "Delay Matrix Calculation Interrupted" << std::endl;
+        interruptedPhase = "DELAY MATRIX CALCULATION";
+    }
+    else if (delayData.mode == DELAY_DENSE || delayData.mode == DELAY_SPARSE) {
+        out << "Delay Matrix Calculation Complete" << std::endl;
+    }
+    else if (delayData.mode == DELAY_UNIT) {
+        out << "Unit Delays Detected, Using Cone Delays Instead of a Delay Matrix" << std::endl;
+    }
+    if (delayCacheFile != "" && !delaysCached && interruptedPhase == ""){
+        if (writeDelayCache(delayCacheFile, delayCacheKey, delayData)){
+            out << "Delay Matrix Written To Cache " << delayCacheFile << std::endl;
         }
-        std::cout << std::endl;
-        for (uint32_t i = 0; i < N; ++i) {
-            std::cout << master.at(i)->strID;
-            for (int j = 0; j < N; ++j) {
-                if(USE_SPARSE){
-                    std::cout << "\t" << sparse_delay_matrix.get(i,j);
-                }
-                else {
-                    std::cout << "\t" << delay_matrix[N * i + j];
-                }
-            }
-            std::cout << std::endl;
+        else {
+            out << "Error: cannot write delay cache " << delayCacheFile << std::endl;
         }
     }
-    /*
-    // check delay matrix against max_delay calculation (DEBUG)
-    bool max_delay_consistent = true;
-    std::cout << "MAX DELAY CALC RESULTS:" << std::endl;
-    for (auto m : master){
-        std::cout << "\t" << m->strID;
-    }
-    std::cout << std::endl;
-    for(uint32_t i = 0; i < N; ++i){
-        std::cout << master.at(i)->strID;
-        for(uint32_t j=0; j < N; ++j){
-            int m_d = max_delay(master.at(i),master.at(j),master);
-            std::cout << "\t" << m_d;
-            if(USE_DELAY_MATRIX) {
-                if (m_d != delay_matrix[N * i + j]) max_delay_consistent = false;
-            }
-
+    if (CHECKPOINT_FILE != "" && !delaysRestored && interruptedPhase == "" &&
+        (delayData.mode == DELAY_DENSE || delayData.mode == DELAY_SPARSE)){
+        if (!writeDelayCheckpoint(CHECKPOINT_FILE + ".delays", delayData)){
+            out << "Error: cannot write checkpoint " << CHECKPOINT_FILE << ".delays" << std::endl;
         }
-        std::cout << std::endl;
     }
-    ///*
-    if(USE_DELAY_MATRIX) {
-        if (max_delay_consistent) {
-            std::cout << "max_delay function PASSED consistency check" << std::endl;
-        } else {
-            std::cout << "max_delay function FAILED consistency check" << std::endl;
+    auto delayMEnd = sc::high_resolution_clock::now();
+    if (sampleMemory) memReport.sample("DELAY MATRIX CALCULATION");
+    recordDelayMatrixMetrics(delayData);
+    traceComplete("parse", "phase", parsestart, parseEnd, circuitName);
+    traceComplete("topological_sort", "phase", topoStart, topoEnd, circuitName);
+    traceComplete("label_initialization", "phase", labelInitialStart, labelInitialEnd, circuitName);
+    traceComplete("delay_matrix", "phase", delayMStart, delayMEnd, circuitName);
+    if (METRICS.enabled){
+        metricsRecordPhase(circuitName, "parse", sc::duration_cast<sc::nanoseconds>(parseEnd - parsestart).count());
+        metricsRecordPhase(circuitName, "topological_sort", sc::duration_cast<sc::nanoseconds>(topoEnd - topoStart).count());
+        metricsRecordPhase(circuitName, "label_initialization", sc::duration_cast<sc::nanoseconds>(labelInitialEnd - labelInitialStart).count());
+        metricsRecordPhase(circuitName, "delay_matrix", sc::duration_cast<sc::nanoseconds>(delayMEnd - delayMStart).count());
+    }
+
+    if (SWEEP_MODE){
+        //SWEEP MODE: every (s, c) combination shares the parsed graph and the delay matrix
+        std::vector<int> sweepSizes = (SWEEP_SIZES != "") ? parseIntList(SWEEP_SIZES) : std::vector<int>(1, MAX_CLUSTER_SIZE);
+        std::vector<int> sweepDelays = (SWEEP_DELAYS != "") ? parseIntList(SWEEP_DELAYS) : std::vector<int>(1, INTER_CLUSTER_DELAY);
+        std::vector<SweepPoint> points = buildSweepPoints(sweepSizes, sweepDelays, true, USE_LAWLER_LABELING, USE_EXP);
+        int jobs = sweepWorkerCount(NUM_JOBS, N, points);
+        out << "Running " << points.size() << " sweep configurations (" << jobs << " in parallel)" << std::endl;
+
+        auto sweepStart = sc::high_resolution_clock::now();
+        for (auto& p : points){
+            p.opts.tieRank = labelOpts.tieRank;
         }
+        PROGRESS.enabled = false; //several runs at once, one line per loop would interleave
+        runSweep(master, POs, N, delayData, points, jobs);
+        auto sweepEnd = sc::high_resolution_clock::now();
+        metricsRecordPhase(circuitName, "sweep", sc::duration_cast<sc::nanoseconds>(sweepEnd - sweepStart).count());
+        traceComplete("sweep", "phase", sweepStart, sweepEnd, circuitName);
+
+        SweepSharedTimes shared;
+        shared.parseUs = sc::duration_cast<sc::microseconds>(parseEnd - parsestart).count();
+        shared.topoUs = sc::duration_cast<sc::microseconds>(topoEnd - topoStart).count();
+        shared.delayMatrixUs = sc::duration_cast<sc::microseconds>(delayMEnd - delayMStart).count();
+        std::string sweepFileName = "output_" + circuitName + "_sweep.csv";
+        writeSweepSummary(sweepFileName, points, shared, N);
+
+        auto sweepTime = measureExecTime(sweepStart, sweepEnd);
+        if (interruptRequested()) {
+            int completed = 0;
+            for (auto& p : points) completed += p.completed;
+            out << "Sweep Interrupted (" << completed << " of " << points.size() << " Configurations Completed), "
+                << "summary written to " << sweepFileName << std::endl;
+        }
+        else {
+            out << "Sweep Complete (" << sweepTime.first << sweepTime.second << "), summary written to " << sweepFileName << std::endl;
+        }
+        stats.ok = true;
+        stats.nodes = N;
+        stats.totalUs = sc::duration_cast<sc::microseconds>(sweepEnd - parsestart).count();
+        return true;
     }
-     */
-
-
 
    //////      CALCULATE LABELS    ///////
     auto labelClusterStart = sc::high_resolution_clock::now();
-    std::vector<Cluster> clusters;
-    int maxIODelay = 0;
-    int maxLabel = 0;
-    if(!USE_LAWLER_LABELING) {
-
-    // Let Gv be the subgraph containing v and all its predecessors
-        // label_v(x) for all x in Gv\{v}
-            // label_v(x) = label(x) + delay_matrix[x][v]
-    // Let S be the set of nodes in Gv\{v} sorted by decreasing label_v values
-        // remove node one-by-one in sorted order  from S and add it to cluster(v) until size constraint is met
-        // let l1 = max(label_v) of any PI node in cluster(v)
-        // let l2 = max(label_v+delay) of any node remaining in S
-        // label(v) = max(l1,l2)
-
-
-        //todo: consider optimizing this code by changing how and when the ordered set container is used
-
-        for (auto v : master) {
-
-            std::vector<Node *> S;
-
-            for (auto n = master.begin(); n != master.begin()+v->id; ++n){ //set all predecessors' visited flag so we can get predecessors
-                (*n)->visited = false;
-            }
-
-            //skip PIs (label(PI) = delay(pi) already implemented)
-            if (!v->prev.empty()) {
-                for (auto n : v->prev) {
-                    addPredecessors(S, n);
-                }
-            }
-
-            // calculate label_v(x)
-            for (auto x : S) {
-                if (USE_DELAY_MATRIX) {
-                    if(USE_SPARSE){
-                        x->label_v = x->label + sparse_delay_matrix.get(x->id,v->id);
-                    }
-                    else {
-                        x->label_v = x->label + delay_matrix[N * x->id + v->id];
-                    }
-                } else {
-                    x->label_v = x->label + max_delay(x, v, master);
-                }
-            }
-
-            // sort S
-            std::sort(S.begin(), S.end(), compare_lv);
-
-            //DEBUG
-            /*
-            std::cout << "S for Node " << v->strID << " has." << std::endl;
-            for(auto s : S){
-                std::cout << s->strID << " ,";
-            }
-            std::cout << std::endl;
-            */
-
-
-
-            Cluster cl(v->id);
-            cl.members.push_back(v);
-
-            // pop first element from S and add to c until max cluster size reached or S is empty
-            for (int i = 1; i < MAX_CLUSTER_SIZE; ++i) { //i starts at 1 to include initial element already in cluster
-                if (S.empty()) break;
-                cl.members.push_back(*S.begin());
-                S.erase(S.begin());
-            }
-
-            if (!v->prev.empty()) {
-                int L2 = 0;
-                if (!S.empty()) {
-
-                    L2 = (*S.begin())->label_v + INTER_CLUSTER_DELAY;
-                }
-                int L1 = cl.calcL1Value();
-                //DEBUG
-                //std::cout << v->strID << "'s L1 value: " << L1 << std::endl;
-                //std::cout << v->strID << "'s L2 value: " << L2 << std::endl;
-
-
-                v->label = (L1 > L2) ? L1 : L2;
-            }
-            maxLabel = (v->label > maxLabel) ? v->label : maxLabel;
-            generateInputSet(cl);
-            clusters.push_back(cl);
+    //the output files are written by a background thread while nodes get labeled and clusters selected
+    OutputWriter outputWriter(circuitName, MAX_CLUSTER_SIZE, INTER_CLUSTER_DELAY, PRIMARY_INPUT_DELAY, PRIMARY_OUTPUT_DELAY,
+                              NODE_DELAY, USE_LAWLER_LABELING, useGui, USE_EXP);
+    labelOpts.nodeLabeled = [&](size_t i){
+        outputWriter.node(master[i], result.labels[master[i]->id], USE_LAWLER_LABELING ? nullptr : &result.clusters[i].members);
+    };
+    labelOpts.clusterSelected = [&](const Cluster* cl){
+        outputWriter.cluster(master[cl->id], cl->members);
+    };
+    if (ECO_MODE){
+        computeLabelsIncremental(master, rawNodeList, ecoState, labelOpts, result, ecoStats);
+        applyLabels(master, result);
+        out << "ECO: " << ecoStats.changed << " changed nodes, " << ecoStats.dirty << " relabeled ("
+            << ecoStats.reordered << " for ties only), " << ecoStats.reused << " labels reused" << std::endl;
+    }
+    else if (APPROX_MODE){
+        //rounded up, so a budget below 1 ms is still a budget and not the 0 that means none
+        long long budgetMs = (TIME_BUDGET > 0) ? std::max(1LL, (long long) std::ceil(TIME_BUDGET * 1000)) : 0;
+        computeLabelsApproximate(master, labelOpts, result, APPROX_CONE, budgetMs, approxStats);
+        applyLabels(master, result);
+        out << "Approximate Labeling: " << approxStats.cutCones << " nodes labeled from part of their cone, "
+            << approxStats.budgetNodes << " as single node clusters after the time budget" << std::endl;
+    }
+    else if (LABEL_PROCESSES != 1){
+        PartitionStats partitionStats;
+        std::string error;
+        if (!computeLabelsPartitioned(master, delayData, labelOpts, result, partitionProcessCount(LABEL_PROCESSES),
+                                      partitionStats, error)){
+            out << "Error: " << error << std::endl;
+            return false;
         }
+        applyLabels(master, result);
+        out << "Partitioned Labeling: " << partitionStats.processes << " processes, " << partitionStats.levels
+            << " levels (largest " << partitionStats.largestLevel << " nodes)" << std::endl;
     }
-    else{
-        // LAWLER LABELING ALGORITHM
-        // For each PI node, label = 0 (already implemented above)
-        // For each non PI node v
-            // p = maximum label of predecessors
-            // Xp = set of predecessors with label p
-            // if |Xp| < MAX_CLUSTER_SIZE
-                // L(v) = p
-            // else
-                // L(v) = p+1
-        // nodes with the same label go in the same cluster
-
-        for(auto v : master){ //traversing in topological order guarantees all predecessors of v will be labeled
-            if(!v->isPI){
-                int max = 0;
-                int count = 0;
-                for (auto n = master.begin(); n != master.begin()+v->id; ++n){ //set all predecessors' visited flag so we can get predecessors
-                    (*n)->visited = false;
-                }
-                std::vector<Node *> pre;
-                for(auto n : v->prev){
-                    addPredecessors(pre, n);
-                }
-                for(auto p : pre){
-                    if(p->label == max){ //keep a count of the number of predecessors with max label
-                        ++count;
-                    }
-                    else if(p->label > max){
-                        max = p->label;
-                        count = 1;
-                    }
-                    /*if (USE_DELAY_MATRIX){
-                        if (USE_SPARSE){
-                            maxIODelay = (sparse_delay_matrix.get(p->id,v->id) > maxIODelay) ? sparse_delay_matrix.get(p->id,v->id) : maxIODelay;
-                        }
-                        else {
-                            maxIODelay = (delay_matrix[N * p->id + v->id] > maxIODelay) ? delay_matrix[N * p->id + v->id] : maxIODelay;
-                        }
-                    }
-                    else {
-                      maxIODelay = (max_delay(p, v, master) > maxIODelay) ? max_delay(p, v, master) : maxIODelay;
-                    }*/
-                    maxIODelay = (max_delay(p, v, master) > maxIODelay) ? max_delay(p, v, master) : maxIODelay;
-                }
-                if(count < MAX_CLUSTER_SIZE){
-                    v->label = max;
-                }
-                else{
-                    v->label = max+1;
+    else {
+        if (CHECKPOINT_FILE != ""){
+            labelOpts.checkpoint = [&](LabelingResult& partial){
+                if (!writeCheckpoint(CHECKPOINT_FILE, rawNodeList, master, partial, labelOpts,
+                                     PRIMARY_INPUT_DELAY, PRIMARY_OUTPUT_DELAY, NODE_DELAY)){
+                    out << "Error: cannot write checkpoint " << CHECKPOINT_FILE << std::endl;
                 }
-            }
-            maxLabel = (v->label > maxLabel) ? v->label : maxLabel;
+            };
+            labelOpts.checkpointIntervalMs = (long long) CHECKPOINT_INTERVAL * 1000;
         }
-        for(auto n : master){ //prepare for recursive clustering, set visited node to false so we only add each node once
-            n->visited = false;
+        engine.computeLabels();
+        if (CHECKPOINT_FILE != "" && result.interrupted){
+            //the partial clusters padded in by computeLabels are not part of the checkpoint
+            labelOpts.checkpoint(result);
+            out << "Checkpoint Written, Continue With --resume " << CHECKPOINT_FILE << std::endl;
         }
-        for(auto PO : POs){
-            lawler_cluster(master, PO, clusters);
+        else if (CHECKPOINT_FILE != ""){
+            removeCheckpoint(CHECKPOINT_FILE);
         }
-
-
+        labelOpts.checkpoint = nullptr;
     }
-    auto labelClusterEnd = sc::high_resolution_clock::now();
-
-    std::cout << "Calculation of Labels and Clusters Complete" << std::endl;
-
-    //DEBUG
-    /*
-    for (auto m : master){
-        std::cout << "LABEL FOR NODE " << m->strID << ": " << m->label << std::endl;
+    //ECO and partitioned labeling report no nodes; an interrupted run ends with nodes that keep their initial label
+    for (size_t i = outputWriter.nodesWritten(); i < master.size(); ++i){
+        labelOpts.nodeLabeled(i);
     }
-    */
-    /*
-    for(auto cluster : clusters){
-        std::cout << "\nCluster " << cluster.id << "(" << master.at(cluster.id)->strID << ") has: " << std::endl;
-        for(auto member : cluster.members){
-            std::cout << member->id << " (" << member->strID << ")" << std::endl;
-        }
-
-        std::cout << "\nCluster " << cluster.id << "(" << master.at(cluster.id)->strID << ") has inputs: " << std::endl;
-        for(auto in : cluster.inputSet){
-            std::cout << in->id << " (" << in->strID << ")" << std::endl;
+    auto labelClusterEnd = sc::high_resolution_clock::now();
+    if (sampleMemory) memReport.sample("LABEL AND INITIAL CLUSTERING PHASE");
+    if (SAVE_STATE_FILE != "" && !USE_LAWLER_LABELING && !result.interrupted){
+        if (!saveEcoState(SAVE_STATE_FILE, master, POs, result, labelOpts, PRIMARY_INPUT_DELAY, PRIMARY_OUTPUT_DELAY, NODE_DELAY)){
+            out << "Error: cannot write state file " << SAVE_STATE_FILE << std::endl;
         }
-
     }
-    */
-    std::vector<Cluster *> finalClusterList;
-    std::vector<std::vector<Node*>> L_HISTORY;
-    auto clusterPhaseStart = sc::high_resolution_clock::now();
-    if(!USE_LAWLER_LABELING) { //for RW
-        //CLUSTERING PHASE
-        std::vector<Node *> L;
-
-        std::copy(POs.begin(), POs.end(), std::back_inserter(L)); //Generate L as the set of all POs in the circuit
-        if (USE_GUI){
-            L_HISTORY.push_back(L);
-        }
-        //using visited flag to tell if a node has been placed into the final cluster list
-        for(Node* n : master){
-            n->visited = false;
-        }
-
-        if (USE_EXP2){
-            //experimental code to remove redundant clusters
-            //Iterate through node list in reverse topological order
-            //If a node is unvisited, add the cluster for which this node is the head
-            //For each node in the added cluster, set visited
-            //DOES NOT SUPPORT GUI
-            for(auto n : master){
-                n->visited = false;
-            }
-            for(auto it = master.rbegin(); it != master.rend(); ++it){
-                if(!(*it)->visited) {
-                    Cluster *cl = &(clusters.at((*it)->id));
-                    finalClusterList.push_back(cl);
-                    for(auto member : cl->members){
-                        member->visited = true;
-                    }
-                }
-            }
-        }
-        else {
-            while (!L.empty()) {
-                //retrieve first element of L and pop from L
-                Node *lNode = *L.begin();
-                L.erase(L.begin());
-
-                //add cluster to finalClusterList
-                Cluster *cl = &(clusters.at(lNode->id));
-                finalClusterList.push_back(cl);
-
-                if (USE_EXP) {
-                    //Experiment Method
-                    for (auto iNode : cl->inputSet) {
-                        //std::cout << "Checking if " << iNode->strID << " can be excluded" << std::endl;
-                        bool alreadyAdded = true;
-                        for (auto n : clusters.at(iNode->id).members) {
-                            if(!n->visited){
-                                //std::cout << "Member " << n->strID << " has NOT been clustered" << std::endl;
-                                alreadyAdded = false;
-                            }
-                            // DEBUG
-                            /*
-                            else{
-                                std::cout << "Member " << n->strID << " HAS been clustered" << std::endl;
-                            }
-                            */
-                        }
-                        // DEBUG
-                        if(alreadyAdded){
-                            //std::cout << "Refusing to add node " << iNode->strID << " to L set" << std::endl;
-                        }
-                        if (!alreadyAdded && retrieveNodeByStr_ptr(iNode->strID, L) == nullptr) {
-                            L.push_back(iNode);
-                            for(Node* n : clusters.at(iNode->id).members){
-                                n->visited = true;
-                                //std::cout << n->strID << " was just clustered" << std::endl;
-                            }
-                        }
-                    }
-                } else {
-                    //add any node in input(lNode's cluster) whose cluster is not in the finalClusterList
-                    for (auto iNode : cl->inputSet) {
-                        if (!Cluster::isClusterInList(iNode->id, finalClusterList) &&
-                            retrieveNodeByStr_ptr(iNode->strID, L) == nullptr) {
-                            L.push_back(iNode);
-                        }
-                    }
-                }
 
-
-                if (USE_GUI) {
-                    L_HISTORY.push_back(L);
-                }
-            }
-        }
+    if (result.interrupted) {
+        out << "Labeling Interrupted (" << result.labeledNodes << " of " << N << " Nodes Labeled), Writing Partial Results" << std::endl;
     }
-    else{ //for lawler labeling, just insert clusters into final cluster list as they are
-        for(auto it = clusters.begin(); it != clusters.end(); ++it){
-            finalClusterList.push_back(&(*it));
-        }
+    else {
+        out << "Calculation of Labels and Clusters Complete" << std::endl;
     }
+    if (result.interrupted && interruptedPhase == "") {
+        interruptedPhase = "LABELING";
+    }
+
+    auto clusterPhaseStart = sc::high_resolution_clock::now();
+    engine.computeClusters();
     auto clusterPhaseEnd = sc::high_resolution_clock::now();
+    if (sampleMemory){
+        memReport.sample("CLUSTERING PHASE");
+        measureStructures(memReport, rawNodeList, master, delayData, result);
+    }
+
+    std::vector<Cluster>& clusters = result.clusters;
+    std::vector<Cluster *>& finalClusterList = result.finalClusterList;
+    std::vector<std::vector<Node*>>& L_HISTORY = result.lHistory;
+    int maxIODelay = result.maxIODelay;
+    int maxIODelay_LAWLERMODIFIED = result.maxIODelayLawlerModified;
+    int maxLabel = result.maxLabel;
 
     //DEBUG
     /*
-    std::cout << "FINAL CLUSTER LIST: " << std::endl;
+    out << "FINAL CLUSTER LIST: " << std::endl;
     for (auto c : finalClusterList){
-        std::cout << "CLUSTER " << master.at(c->id)->strID << ": [";
+        out << "CLUSTER " << master.at(c->id)->strID << ": [";
         for (auto mem : c->members){
-            std::cout << mem->strID << ",";
+            out << mem->strID << ",";
         }
-        std::cout << "]" << std::endl;
+        out << "]" << std::endl;
     }
     */
 
-    int maxIODelay_LAWLERMODIFIED = maxIODelay;
-    if (!USE_LAWLER_LABELING){
-        //RW Clustering has max label = max PI-PO delay
-        maxIODelay = maxLabel;
+    if (result.interrupted && interruptedPhase == "") {
+        interruptedPhase = "CLUSTERING";
+        out << "Clustering Interrupted (" << finalClusterList.size() << " Clusters Selected), Writing Partial Results" << std::endl;
     }
-    else {
-        maxIODelay = maxIODelay + maxLabel;
-        maxIODelay_LAWLERMODIFIED = maxIODelay + maxLabel*INTER_CLUSTER_DELAY;
+    else if (!result.interrupted) {
+        out << "PROGRAM COMPLETE" << std::endl;
     }
 
-
-    std::cout << "PROGRAM COMPLETE" << std::endl;
-
     //STATISTICS
-    long int CLUSTER_AREA_COST = 0;
+    long int CLUSTER_AREA_COST = result.clusterAreaCost;
     float AREA_COST = 0.0f;
     //print to files
-    writeOutputFiles(BLIFFile.substr(0,BLIFFile.length()-5),
-                     master,clusters,finalClusterList,
-                     MAX_CLUSTER_SIZE,INTER_CLUSTER_DELAY,PRIMARY_INPUT_DELAY,PRIMARY_OUTPUT_DELAY,NODE_DELAY,
-                     USE_LAWLER_LABELING,USE_GUI,USE_EXP);
-    if (USE_GUI && !USE_LAWLER_LABELING) {
+    auto outputStart = sc::high_resolution_clock::now();
+    outputWriter.finish(); //only the rows the writer has not caught up with yet
+    labelOpts.nodeLabeled = nullptr;
+    labelOpts.clusterSelected = nullptr;
+    if (USE_BINARY_OUTPUT) {
+        std::string resultFileName = "output_" + circuitName + "_result.rwb";
+        if (!writeBinaryResultFile(resultFileName,
+                                   master,clusters,finalClusterList,maxIODelay,
+                                   MAX_CLUSTER_SIZE,INTER_CLUSTER_DELAY,PRIMARY_INPUT_DELAY,PRIMARY_OUTPUT_DELAY,NODE_DELAY,
+                                   USE_LAWLER_LABELING,useGui,USE_EXP)){
+            out << "Error: cannot write result file " << resultFileName << std::endl;
+        }
+    }
+    if (useGui && !USE_LAWLER_LABELING) {
         writeGUIFile(master, clusters, finalClusterList, L_HISTORY, maxIODelay, UNIX_RUN);
     }
+    auto outputEnd = sc::high_resolution_clock::now();
+    if (sampleMemory) memReport.sample("OUTPUT FILES");
+    if (METRICS.enabled){
+        for (auto& st : memReport.structures){
+            metricsRecordMemory(circuitName, st.name, st.bytes);
+        }
+        for (auto& sm : memReport.samples){
+            metricsRecordMemory(circuitName, "PEAK RSS AFTER " + sm.phase, sm.hwmKB * 1024);
+            if (sm.hugePagesKB > 0) metricsRecordMemory(circuitName, "HUGE PAGES AFTER " + sm.phase, sm.hugePagesKB * 1024);
+        }
+    }
+    traceComplete("labeling", "phase", labelClusterStart, labelClusterEnd, circuitName);
+    traceComplete("clustering", "phase", clusterPhaseStart, clusterPhaseEnd, circuitName);
+    traceComplete("output_files", "phase", outputStart, outputEnd, circuitName);
+    if (METRICS.enabled){
+        metricsRecordPhase(circuitName, "labeling", sc::duration_cast<sc::nanoseconds>(labelClusterEnd - labelClusterStart).count());
+        metricsRecordPhase(circuitName, "clustering", sc::duration_cast<sc::nanoseconds>(clusterPhaseEnd - clusterPhaseStart).count());
+        metricsRecordPhase(circuitName, "output_files", sc::duration_cast<sc::nanoseconds>(outputEnd - outputStart).count());
+    }
 
     std::ofstream verboseFile;
 
-    verboseFile.open("output_" + BLIFFile.substr(0, BLIFFile.length() - 5) + "_verbose.txt", std::fstream::app);
+    verboseFile.open("output_" + circuitName + "_verbose.txt", std::fstream::app);
 
 
     std::vector<std::pair<long long int,std::string>> execTimes;
@@ -677,133 +546,431 @@ int main(int argc, char **argv) {
     execTimes.push_back(measureExecTime(clusterPhaseStart,clusterPhaseEnd));
 
     //print out execution times for each code section
-    std::cout << "\n------------------------------------\nSTATISTICS:" << std::endl;
+    out << "\n------------------------------------\nSTATISTICS:" << std::endl;
     verboseFile << "\n----------STATISTICS----------\n" << std::endl;
-    std::cout << "TOTAL NUMBER OF NODES:\t" << N << std::endl;
+    out << "TOTAL NUMBER OF NODES:\t" << N << std::endl;
     verboseFile << "TOTAL NUMBER OF NODES:\t" << N << std::endl;
-    std::cout << "NUMBER OF CLUSTERS:\t" << finalClusterList.size() << std::endl;
+    out << "NUMBER OF CLUSTERS:\t" << finalClusterList.size() << std::endl;
     verboseFile << "NUMBER OF CLUSTERS:\t" << finalClusterList.size() << std::endl;
     if (USE_LAWLER_LABELING) {
-        std::cout << "MAX LABEL:\t" << maxLabel << std::endl;
+        out << "MAX LABEL:\t" << maxLabel << std::endl;
         verboseFile << "MAX LABEL:\t" << maxLabel << std::endl;
-        std::cout << "MAX IO PATH DELAY (UNIT DELAY MODEL):\t" << maxIODelay << std::endl;
+        out << "MAX IO PATH DELAY (UNIT DELAY MODEL):\t" << maxIODelay << std::endl;
         verboseFile << "MAX IO PATH DELAY (UNIT DELAY MODEL):\t" << maxIODelay << std::endl;
-        std::cout << "MAX IO PATH DELAY (GENERAL DELAY MODEL):\t" << maxIODelay_LAWLERMODIFIED << std::endl;
+        out << "MAX IO PATH DELAY (GENERAL DELAY MODEL):\t" << maxIODelay_LAWLERMODIFIED << std::endl;
         verboseFile << "MAX IO PATH DELAY (GENERAL DELAY MODEL):\t" << maxIODelay_LAWLERMODIFIED << std::endl;
     }
     else {
-        std::cout << "MAX IO PATH DELAY:\t" << maxIODelay << std::endl;
+        out << "MAX IO PATH DELAY:\t" << maxIODelay << std::endl;
         verboseFile << "MAX IO PATH DELAY:\t" << maxIODelay << std::endl;
     }
-    for (auto cl : finalClusterList){
-        for (auto mem : cl->members){
-            CLUSTER_AREA_COST += 1;
-        }
-    }
-    std::cout << "----------EXECUTION TIMES----------" << std::endl;
+    if (APPROX_MODE && !result.interrupted) {
+        //the clusters above reach maxIODelay = the upper bound; exact RW clustering lies within the bounds
+        out << "MAX IO PATH DELAY LOWER BOUND:\t" << approxStats.lowerBound << std::endl;
+        verboseFile << "MAX IO PATH DELAY LOWER BOUND:\t" << approxStats.lowerBound << std::endl;
+        out << "MAX IO PATH DELAY UPPER BOUND:\t" << approxStats.upperBound << std::endl;
+        verboseFile << "MAX IO PATH DELAY UPPER BOUND:\t" << approxStats.upperBound << std::endl;
+        out << "APPROXIMATED NODES:\t" << approxStats.cutCones + approxStats.budgetNodes << std::endl;
+        verboseFile << "APPROXIMATED NODES:\t" << approxStats.cutCones + approxStats.budgetNodes << std::endl;
+    }
+    if (result.interrupted) {
+        out << "RUN INTERRUPTED DURING:\t" << interruptedPhase << std::endl;
+        verboseFile << "RUN INTERRUPTED DURING:\t" << interruptedPhase << std::endl;
+        out << "LABELED NODES:\t" << result.labeledNodes << std::endl;
+        verboseFile << "LABELED NODES:\t" << result.labeledNodes << std::endl;
+    }
+    if (ECO_MODE) {
+        out << "ECO CHANGED NODES:\t" << ecoStats.changed << std::endl;
+        verboseFile << "ECO CHANGED NODES:\t" << ecoStats.changed << std::endl;
+        out << "ECO RELABELED NODES:\t" << ecoStats.dirty << std::endl;
+        verboseFile << "ECO RELABELED NODES:\t" << ecoStats.dirty << std::endl;
+        out << "ECO REORDERED NODES:\t" << ecoStats.reordered << std::endl;
+        verboseFile << "ECO REORDERED NODES:\t" << ecoStats.reordered << std::endl;
+        out << "ECO REUSED LABELS:\t" << ecoStats.reused << std::endl;
+        verboseFile << "ECO REUSED LABELS:\t" << ecoStats.reused << std::endl;
+    }
+    out << "----------EXECUTION TIMES----------" << std::endl;
     verboseFile << "\n----------EXECUTION TIMES----------\n" << std::endl;
     for (uint32_t i=0; i < execStrs.size(); ++i){
-        std::cout << execStrs.at(i) << ":\t" << execTimes.at(i).first << execTimes.at(i).second << std::endl;
+        out << execStrs.at(i) << ":\t" << execTimes.at(i).first << execTimes.at(i).second << std::endl;
         verboseFile << execStrs.at(i) << ":\t" << execTimes.at(i).first << execTimes.at(i).second << std::endl;
     }
 
     verboseFile.close();
-    if(UNIX_RUN){
-        reportMemUsage(BLIFFile.substr(0, BLIFFile.length() - 5));
+    if(UNIX_RUN && !quiet){
+        reportMemUsage(circuitName); //process wide, so not meaningful when several circuits share the process
+    }
+    verboseFile.open("output_" + circuitName + "_verbose.txt", std::fstream::app);
+    if (MEM_REPORT){
+        writeMemoryReport(out, verboseFile, memReport);
     }
-    verboseFile.open("output_" + BLIFFile.substr(0, BLIFFile.length() - 5) + "_verbose.txt", std::fstream::app);
 
-    std::cout << "----------AREA ANALYSIS----------" << std::endl;
+    out << "----------AREA ANALYSIS----------" << std::endl;
     verboseFile << "\n----------AREA ANALYSIS----------\n" << std::endl;
-    std::cout << "NOTE: Assuming unit area per node" << std::endl;
+    out << "NOTE: Assuming unit area per node" << std::endl;
     verboseFile << "NOTE: Assuming unit area per node" << std::endl;
-    std::cout << "ORIGINAL AREA:\t" << N << std::endl;
+    out << "ORIGINAL AREA:\t" << N << std::endl;
     verboseFile << "ORIGINAL AREA:\t" << N << std::endl;
-    std::cout << "CLUSTERED AREA:\t" << CLUSTER_AREA_COST << std::endl;
+    out << "CLUSTERED AREA:\t" << CLUSTER_AREA_COST << std::endl;
     verboseFile << "CLUSTERED AREA:\t" << CLUSTER_AREA_COST << std::endl;
-    std::cout << "AREA INCREASED BY FACTOR OF " << ((float) CLUSTER_AREA_COST)/((float)N) << std::endl;
+    out << "AREA INCREASED BY FACTOR OF " << ((float) CLUSTER_AREA_COST)/((float)N) << std::endl;
     verboseFile << "AREA INCREASED BY FACTOR OF " << ((float) CLUSTER_AREA_COST)/((float)N) << std::endl;
 
     verboseFile.close();
 
-    if(USE_DELAY_MATRIX && !USE_SPARSE) {
-        delete[] delay_matrix;
-    }
-
-    return 0;
+    stats.ok = !result.interrupted;
+    stats.nodes = N;
+    stats.clusters = finalClusterList.size();
+    stats.maxIODelay = USE_LAWLER_LABELING ? maxIODelay_LAWLERMODIFIED : maxIODelay;
+    stats.clusterAreaCost = CLUSTER_AREA_COST;
+    stats.parseUs = sc::duration_cast<sc::microseconds>(parseEnd - parsestart).count();
+    stats.topoUs = sc::duration_cast<sc::microseconds>(topoEnd - topoStart).count();
+    stats.delayMatrixUs = sc::duration_cast<sc::microseconds>(delayMEnd - delayMStart).count();
+    stats.labelUs = sc::duration_cast<sc::microseconds>(labelClusterEnd - labelClusterStart).count();
+    stats.clusterUs = sc::duration_cast<sc::microseconds>(clusterPhaseEnd - clusterPhaseStart).count();
+    stats.totalUs = sc::duration_cast<sc::microseconds>(clusterPhaseEnd - parsestart).count();
+    return true;
 }
 
-//adds a node and its predecessors to vector in topological order
-void addPredecessors(std::vector<Node *> &m, Node *n){
-    if(n->visited) return;
-    for(auto node : n->prev){
-        if (!node->visited) addPredecessors(m, node);
+//writes the --trace and --metrics files; metric counters are summed over every circuit and sweep run of the process
+static void writeProfileFiles(){
+    if (TRACE.enabled && !writeTraceFile(TRACE_FILE)){
+        std::cout << "Error: cannot write trace file " << TRACE_FILE << std::endl;
+    }
+    if (!METRICS.enabled) return;
+    std::vector<std::pair<std::string,std::string>> params = {
+        {"input", (BATCH_PATH != "") ? BATCH_PATH : FILENAME},
+        {"max_cluster_size", std::to_string(MAX_CLUSTER_SIZE)},
+        {"intercluster_delay", std::to_string(INTER_CLUSTER_DELAY)},
+        {"pi_delay", std::to_string(PRIMARY_INPUT_DELAY)},
+        {"po_delay", std::to_string(PRIMARY_OUTPUT_DELAY)},
+        {"node_delay", std::to_string(NODE_DELAY)},
+        {"labeling", USE_LAWLER_LABELING ? "lawler" : "rw"},
+        {"delay_matrix", !USE_DELAY_MATRIX ? "none" : (USE_SPARSE ? "sparse" : "dense")},
+        {"unit_delay", USE_UNIT_DELAY ? "auto" : "off"},
+        {"label_threads", std::to_string(labelThreadCount(LABEL_THREADS))},
+        {"exp", USE_EXP ? "true" : "false"}
+    };
+    if (!writeMetricsFile(METRICS_FILE, params)){
+        std::cout << "Error: cannot write metrics file " << METRICS_FILE << std::endl;
     }
-    n->visited = true; //todo: remove the need for a visited flag by using a more efficient method
-    m.push_back(n);
-    //std::cout << "Adding " << n->strID  << " to master." << std::endl; //debug
 }
 
-//find longest path in the DAG using topological ordering properties
-//requirement: nodes must be topologically sorted with sequential IDs (starting at 0)
-int max_delay(Node* src, Node* dst, std::vector<Node *> nodes){
-    if(src->id >= dst->id) return 0; //no path between these nodes if src does not come before dst
-    int offset = src->id; //use offset to avoid making the delays array longer than necessary
-    int delays[dst->id - offset + 1]; //a delay value for all topological nodes between src and dst (inclusive)
-    for(int i=0; i<=dst->id-offset; ++i){ //initialize delays vector to -1 for each node
-        delays[i] = -1;
-    }
-    //set delay of source to 0
-    delays[0] =  0;
-    for(int i=0; i<dst->id-offset; ++i){
-        if(delays[i] != -1){
-            for(auto it = nodes[i+offset]->next.begin(); it != nodes[i+offset]->next.end(); ++it){
-                if((*it)->id <= dst->id) { //don't operate on nodes which come topologically after dst
-                    if(delays[(*it)->id - offset] < delays[i]+(*it)->delay){
-                        delays[(*it)->id - offset] = delays[i]+(*it)->delay;
-                    }
-                }
-            }
+int main(int argc, char **argv) {
+
+    //parse arguments
+    int HELP_FLAG = 0;
+    const struct option longopts[] =
+    {
+        {"lawler", no_argument,     &USE_LAWLER_LABELING, 1},
+        {"no_matrix", no_argument, &USE_DELAY_MATRIX, 0},
+        {"no_sparse", no_argument, &USE_SPARSE, 0},
+        {"no_huge_pages", no_argument, &USE_HUGE_PAGES, 0},
+        {"no_unit_delay", no_argument, &USE_UNIT_DELAY, 0},
+        {"help", no_argument, nullptr, 'h'},
+        {"max_cluster_size", required_argument, nullptr, 's'},
+        {"pi_delay", required_argument, nullptr, 'i'},
+        {"po_delay", required_argument, nullptr, 'o'},
+        {"node_delay", required_argument, nullptr, 'n'},
+        {"intercluster_delay", required_argument, nullptr, 'c'},
+        {"gui",no_argument,&USE_GUI,1},
+        {"exp",no_argument,&USE_EXP,1},
+        {"binary",no_argument,&USE_BINARY_OUTPUT,1},
+        {"renumber",no_argument,&RENUMBER,1},
+        {"mem_report",no_argument,&MEM_REPORT,1},
+        {"progress",no_argument,&FORCE_PROGRESS,1},
+        {"no_progress",no_argument,&NO_PROGRESS,1},
+        {"sweep_s", required_argument, nullptr, 'S'},
+        {"sweep_c", required_argument, nullptr, 'C'},
+        {"jobs", required_argument, nullptr, 'j'},
+        {"label_threads", required_argument, nullptr, 'L'},
+        {"parallel_cone_min", required_argument, nullptr, 'P'},
+        {"processes", required_argument, nullptr, 'p'},
+        {"batch", required_argument, nullptr, 'b'},
+        {"save_state", required_argument, nullptr, 'w'},
+        {"eco", required_argument, nullptr, 'e'},
+        {"eco_diff", required_argument, nullptr, 'd'},
+        {"metrics", required_argument, nullptr, 'm'},
+        {"trace", required_argument, nullptr, 't'},
+        {"trace_sample", required_argument, nullptr, 'T'},
+        {"checkpoint", required_argument, nullptr, 'k'},
+        {"checkpoint_interval", required_argument, nullptr, 'K'},
+        {"resume", required_argument, nullptr, 'r'},
+        {"delay_cache", required_argument, nullptr, 'D'},
+        {"approx_cone", required_argument, nullptr, 'a'},
+        {"time_budget", required_argument, nullptr, 'B'},
+        {0,0,0,0}
+    };
+    int flag;
+    int option_index;
+    while(true){
+        flag = getopt_long(argc, argv, "s:i:o:n:c:", longopts, &option_index);
+        if(flag == -1) break;
+        switch(flag){
+            case 0:
+                break;
+            case 's':
+                MAX_CLUSTER_SIZE = std::atoi(optarg);
+                break;
+            case 'i':
+                PRIMARY_INPUT_DELAY = std::atoi(optarg);
+                break;
+            case 'o':
+                PRIMARY_OUTPUT_DELAY = std::atoi(optarg);
+                break;
+            case 'n':
+                NODE_DELAY = std::atoi(optarg);
+                break;
+            case 'c':
+                INTER_CLUSTER_DELAY = std::atoi(optarg);
+                break;
+            case 'S':
+                SWEEP_SIZES = optarg;
+                break;
+            case 'C':
+                SWEEP_DELAYS = optarg;
+                break;
+            case 'j':
+                NUM_JOBS = std::atoi(optarg);
+                break;
+            case 'L':
+                LABEL_THREADS = std::atoi(optarg);
+                break;
+            case 'P':
+                PARALLEL_CONE_MIN = std::atoi(optarg);
+                break;
+            case 'p':
+                LABEL_PROCESSES = std::atoi(optarg);
+                break;
+            case 'b':
+                BATCH_PATH = optarg;
+                break;
+            case 'w':
+                SAVE_STATE_FILE = optarg;
+                break;
+            case 'e':
+                ECO_STATE_FILE = optarg;
+                break;
+            case 'd':
+                ECO_DIFF_FILE = optarg;
+                break;
+            case 'm':
+                METRICS_FILE = optarg;
+                break;
+            case 't':
+                TRACE_FILE = optarg;
+                break;
+            case 'T':
+                TRACE.sampleRate = std::atoi(optarg);
+                if (TRACE.sampleRate < 1) TRACE.sampleRate = 1;
+                break;
+            case 'k':
+                CHECKPOINT_FILE = optarg;
+                break;
+            case 'K':
+                CHECKPOINT_INTERVAL = std::atoi(optarg);
+                if (CHECKPOINT_INTERVAL < 0) CHECKPOINT_INTERVAL = 0;
+                break;
+            case 'r':
+                RESUME_FILE = optarg;
+                break;
+            case 'D':
+                DELAY_CACHE_DIR = optarg;
+                break;
+            case 'a':
+                APPROX_CONE = std::atoi(optarg);
+                if (APPROX_CONE < 0) APPROX_CONE = 0;
+                break;
+            case 'B':
+                TIME_BUDGET = std::atof(optarg);
+                if (TIME_BUDGET < 0) TIME_BUDGET = 0;
+                break;
+            case 'h':
+                HELP_FLAG = 1;
+            case '?':
+                HELP_FLAG = 1;
+                break;
+            default:
+                std::cout << "Encountered error with command line arguments" << std::endl;
+                abort();
         }
     }
-    if(delays[dst->id - offset] == -1) return 0; //if there was no path from src to dst, return 0
-    return delays[dst->id - offset];
-}
-//similar to addPredecessors, but only adds the node if it has the specified label
-void get_lawler_cluster(std::vector<Node *> &nodes, Node* n, int p, bool* visited){
-    if (visited[n->id]) return;
-    if(n->label == p){
-        for(auto prev : n->prev){
-            get_lawler_cluster(nodes, prev, p,visited);
-        }
-        visited[n->id] = true;
-        nodes.push_back(n);
+    if (optind < argc) {
+        FILENAME = argv[optind];
     }
-}
-void lawler_cluster(std::vector<Node*> &m, Node* n, std::vector<Cluster> &clusters){
-    if(!n->visited) {
-        bool cluster = true;
-        for (auto suc : n->next) { //for each of n's successors
-            if (n->label == suc->label) {
-                cluster = false;
-            }
-        }
-        if (cluster) {
-            std::vector<Node *> clust;
-            bool visited[n->id+1];
-            for(int i=0; i<=n->id; ++i){
-                visited[i] = false;
-            }
-            get_lawler_cluster(clust, n, n->label,visited);
-            Cluster newCluster(n->id);
-            for (auto c : clust) {
-                newCluster.members.push_back(c);
-            }
-            clusters.push_back(newCluster);
-        }
+    else if (ECO_DIFF_FILE != "") {
+        FILENAME = ECO_DIFF_FILE; //output files are named after the diff
+    }
+    if (ECO_STATE_FILE != "" && USE_LAWLER_LABELING) {
+        std::cout << "Error: --eco only supports RW labeling" << std::endl;
+        return -1;
     }
-    n->visited = true;
-    for(auto p : n->prev){
-        lawler_cluster(m,p, clusters);
+    if ((CHECKPOINT_FILE != "" || RESUME_FILE != "") &&
+        (SWEEP_SIZES != "" || SWEEP_DELAYS != "" || BATCH_PATH != "" || ECO_STATE_FILE != "")) {
+        std::cout << "Error: --checkpoint and --resume cannot be combined with sweep, batch or ECO mode" << std::endl;
+        return -1;
     }
+    if (LABEL_PROCESSES != 1 && (USE_LAWLER_LABELING || SWEEP_SIZES != "" || SWEEP_DELAYS != "" || BATCH_PATH != "" ||
+        ECO_STATE_FILE != "" || CHECKPOINT_FILE != "" || RESUME_FILE != "")) {
+        std::cout << "Error: --processes only supports single RW runs (no --lawler, sweep, batch, ECO or checkpoints)" << std::endl;
+        return -1;
+    }
+    if (RENUMBER && (ECO_STATE_FILE != "" || SAVE_STATE_FILE != "" || CHECKPOINT_FILE != "" || RESUME_FILE != "")) {
+        std::cout << "Error: --renumber cannot be combined with ECO state files or checkpoints" << std::endl;
+        return -1;
+    }
+    if ((APPROX_CONE > 0 || TIME_BUDGET > 0) && (USE_LAWLER_LABELING || SWEEP_SIZES != "" || SWEEP_DELAYS != "" ||
+        ECO_STATE_FILE != "" || SAVE_STATE_FILE != "" || LABEL_PROCESSES != 1 || CHECKPOINT_FILE != "" || RESUME_FILE != "")) {
+        std::cout << "Error: --approx_cone and --time_budget only support RW runs (no --lawler, sweep, ECO state files, --processes or checkpoints)" << std::endl;
+        return -1;
+    }
+    if (DELAY_CACHE_DIR != "" && mkdir(DELAY_CACHE_DIR.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cout << "Error: cannot create delay cache directory " << DELAY_CACHE_DIR << std::endl;
+        return -1;
+    }
+    if (RESUME_FILE != "" && CHECKPOINT_FILE == "") {
+        CHECKPOINT_FILE = RESUME_FILE; //a resumed run keeps checkpointing where it left off
+    }
+    if (HELP_FLAG) {
+        std::cout << "\nUsage: rw [arguments] [inputFile.blif]" << std::endl;
+        std::cout << "Options:" << std::endl;
+        std::cout << "-h, --help\t\tShow this help message and exit" << std::endl;
+        std::cout << "--lawler\t\tUse Lawler labeling algorithm instead of RW" << std::endl;
+        std::cout << "--no_matrix\t\tAvoid using a delay matrix, (pays a large runtime penalty at a large memory benefit)" << std::endl;
+        std::cout << "--no_sparse\t\tAvoid using a sparse matrix, (pays a large memory penalty at a small runtime benefit)" << std::endl;
+        std::cout << "--no_huge_pages\tKeep the delay matrix in 4 KB pages (default: ask for transparent huge pages)" << std::endl;
+        std::cout << "--no_unit_delay		Build the delay matrix even when every gate has delay 1 (by default such netlists" << std::endl;
+        std::cout << "			get their delays from each fan-in cone in 8 or 16 bit arrays, with no matrix)" << std::endl;
+        std::cout << "--gui\t\tEnable interactive GUI (pays a runtime penalty for GUI file creation)" << std::endl;
+        std::cout << "--exp\t\tEnable non-overlap for clusters whose members are already covered by queued clusters" << std::endl;
+        std::cout << "--binary\t\tAlso write every label and cluster to a binary result file (output_<circuit>_result.rwb)" << std::endl;
+        std::cout << "\t\t\t(rwb_dump <file> --gui writes GUI files of its clusters, logic levels or node neighbourhoods)" << std::endl;
+        std::cout << "--renumber\tRenumber the nodes so connected logic gets nearby ids when that shrinks the sparse matrix" << std::endl;
+        std::cout << "\t\t\t(same labels and clusters, files list the nodes in the new order)" << std::endl;
+        std::cout << "-s, --max_cluster_size\tSet max cluster size (default 8)" << std::endl;
+        std::cout << "-i, --pi_delay\t\tSet delay for all primary input nodes (default 0)" << std::endl;
+        std::cout << "-o, --po_delay\t\tSet delay for all primary output nodes (default 1)" << std::endl;
+        std::cout << "-n, --node_delay\t\tSet delay for all non-pi and non-po nodes (default 1)" << std::endl;
+        std::cout << "-c, --intercluster_delay\tSet intercluster delay (default 3)" << std::endl;
+        std::cout << "--sweep_s <s1,s2,..>\tSweep mode: run every listed max cluster size (default: -s value)" << std::endl;
+        std::cout << "--sweep_c <c1,c2,..>\tSweep mode: run every listed intercluster delay (default: -c value)" << std::endl;
+        std::cout << "\t\t\tIn sweep mode --lawler and --exp add Lawler and non-overlap runs to each combination;" << std::endl;
+        std::cout << "\t\t\tparsing, sorting and the delay matrix are shared and one summary CSV is written" << std::endl;
+        std::cout << "--jobs <n>\t\tNumber of sweep runs or batch netlists executed in parallel (default: cores," << std::endl;
+        std::cout << "\t\t\tsweeps are also limited by the available memory)" << std::endl;
+        std::cout << "--label_threads <n>\tThreads that split the fan-in cone enumeration, label_v scoring and top-k selection" << std::endl;
+        std::cout << "\t\t\tof giant cones and the rows of the delay matrix between them (default: one per core, 1 in batch mode)" << std::endl;
+        std::cout << "--parallel_cone_min <n>\tCones with fewer nodes are labeled by a single thread (default 16384)" << std::endl;
+        std::cout << "--processes <n>\t\tLabel with n worker processes (0 = one per core) that share the labels through" << std::endl;
+        std::cout << "\t\t\tshared memory, one logic level at a time; a crashed worker fails the run, not the" << std::endl;
+        std::cout << "\t\t\tcoordinator, and the output matches a single process run (default 1)" << std::endl;
+        std::cout << "--batch <dir|list>\tCluster every .blif in a directory (or listed one per line in a file) on a worker pool;" << std::endl;
+        std::cout << "\t\t\tlargest netlists start first, each keeps its own output files, output_batch_report.csv summarizes all" << std::endl;
+        std::cout << "\t\t\t(netlists with the same file name are told apart by their directory: a/x.blif -> output_a_x_*);" << std::endl;
+        std::cout << "\t\t\ta netlist that cannot be read is reported FAILED and the others still run" << std::endl;
+        std::cout << "--save_state <file>\tSave the labels and clusters of an RW run for later --eco runs" << std::endl;
+        std::cout << "--eco <file>\t\tECO mode: reuse a saved state and relabel only the fan-out of changed gates;" << std::endl;
+        std::cout << "\t\t\tlabels and clusters are the same as in a full run of the new BLIF" << std::endl;
+        std::cout << "--eco_diff <diff.blif>\tECO mode: apply the .inputs/.outputs/.latch/.names of a diff BLIF to the saved netlist" << std::endl;
+        std::cout << "\t\t\tinstead of parsing a complete new BLIF (same result as a full run of the edited BLIF" << std::endl;
+        std::cout << "\t\t\twith new outputs and latches appended to the existing ones)" << std::endl;
+        std::cout << "--metrics <out.json>\tWrite phase times (ns) and labeling/clustering counters to a JSON file" << std::endl;
+        std::cout << "--mem_report\t\tReport the bytes held by each data structure and the peak RSS after every phase" << std::endl;
+        std::cout << "--trace <out.json>\tWrite a Chrome/Perfetto timeline (phases, sampled per-node labeling spans," << std::endl;
+        std::cout << "\t\t\tclustering queue length, worker threads)" << std::endl;
+        std::cout << "--trace_sample <n>\tKeep one per-node labeling span in n, plus every span over 1 ms (default 100)" << std::endl;
+        std::cout << "--progress\t\tReport delay matrix, labeling and clustering progress (count, rate, ETA) on stderr" << std::endl;
+        std::cout << "\t\t\teven when it is not a terminal (on by default for terminals)" << std::endl;
+        std::cout << "--no_progress\t\tNever report progress" << std::endl;
+        std::cout << "\t\t\tCtrl-C stops a run after the current node and still writes statistics and the partial" << std::endl;
+        std::cout << "\t\t\tlabels and clusters; a second Ctrl-C exits immediately" << std::endl;
+        std::cout << "--checkpoint <file>\tSave the labeling state to <file> periodically and when interrupted, and the" << std::endl;
+        std::cout << "\t\t\tdelay matrix to <file>.delays once it is built; both are deleted when labeling completes" << std::endl;
+        std::cout << "--checkpoint_interval <s>\tSeconds between two labeling checkpoints (default 300)" << std::endl;
+        std::cout << "--resume <file>\t\tContinue the labeling of a checkpoint with the same netlist and -s/-c/-i/-o/-n/--lawler;" << std::endl;
+        std::cout << "\t\t\tthe output matches an uninterrupted run (keeps checkpointing to <file> unless --checkpoint is given)" << std::endl;
+        std::cout << "--approx_cone <n>\tApproximate RW: label every node from at most n candidates of its fan-in cone" << std::endl;
+        std::cout << "\t\t\t(the closest ones in topological order) and charge the rest the intercluster delay; no delay" << std::endl;
+        std::cout << "\t\t\tmatrix is built and the statistics add a lower and an upper bound on the exact max IO delay" << std::endl;
+        std::cout << "--time_budget <s>\tApproximate RW: after s seconds of labeling, label the remaining nodes as single node" << std::endl;
+        std::cout << "\t\t\tclusters in linear time (combines with --approx_cone, bounds are reported the same way; s is rounded up to whole ms)" << std::endl;
+        std::cout << "--delay_cache <dir>\tKeep each circuit's delay matrix in <dir>/<circuit>.rwdc and map it in later runs with the" << std::endl;
+        std::cout << "\t\t\tsame netlist, -i/-o/-n, matrix type and order (-s/-c/--exp may differ); a stale cache is rebuilt" << std::endl;
+
+        return 0;
+    }
+
+    if (UNIX_RUN){
+        BLIFFile = FILENAME;
+    }
+    else {
+        BLIFFile = "../" + FILENAME;
+    }
+
+    METRICS.enabled = (METRICS_FILE != "");
+    TRACE.enabled = (TRACE_FILE != "");
+    PROGRESS.enabled = !NO_PROGRESS && (FORCE_PROGRESS || isatty(fileno(stderr)));
+    installInterruptHandler();
+    traceThreadName("main");
+    setHugePages(USE_HUGE_PAGES);
+
+    bool SWEEP_MODE = (SWEEP_SIZES != "" || SWEEP_DELAYS != "");
+    if(USE_LAWLER_LABELING && !SWEEP_MODE){
+        USE_DELAY_MATRIX = false;//delay matrix should not be calculated for lawler labeling
+    }
+
+
+    /*
+    std::cout << "RWClustering Application" << "\nAuthors: Akshay Nagendra <akshaynag@gatech.edu>, Paul Yates <pyates6@gatech.edu>" << std::endl;
+    std::cout << "------------------------------------" << std::endl;
+    std::cout << "Input File: " << FILENAME.c_str() << std::endl;
+    std::cout << "Max Cluster Size = " << MAX_CLUSTER_SIZE << std::endl;
+    std::cout << "PI Node Delay = " << PRIMARY_INPUT_DELAY << std::endl;
+    std::cout << "PO Node Delay = " << PRIMARY_OUTPUT_DELAY << std::endl;
+    std::cout << "Normal Node Node Delay = " << NODE_DELAY << std::endl;
+    std::cout << "Inter Cluster Delay = " << INTER_CLUSTER_DELAY << std::endl;
+    if(USE_LAWLER_LABELING){
+        std::cout << "Using Lawler Labeling" << std::endl;
+    }
+    if(USE_DELAY_MATRIX) {
+        std::cout << "Using Delay Matrix" << std::endl;
+    }
+    if (USE_GUI){
+        std::cout << "Interctive GUI: Enabled" << std::endl;
+    }
+    else {
+        std::cout << "Interctive GUI: Disabled" << std::endl;
+    }
+    */
+
+    if (BATCH_PATH != ""){
+        //BATCH MODE: every netlist runs the full flow on a worker pool, largest netlists first
+        USE_GUI = 0;
+        PROGRESS.enabled = false; //netlists run side by side; "Completed" lines report the progress
+        std::vector<BatchJob> batch = collectBatchFiles(BATCH_PATH);
+        if (batch.empty()){
+            std::cout << "Error: no BLIF files found in " << BATCH_PATH << std::endl;
+            return -1;
+        }
+        int jobs = batchWorkerCount(NUM_JOBS, batch);
+        std::cout << "Clustering " << batch.size() << " netlists (" << jobs << " workers)" << std::endl;
+        auto batchStart = sc::high_resolution_clock::now();
+        runBatch(batch, jobs, [](BatchJob& job){
+            if (interruptRequested()) return; //not started, stays failed in the report
+            bool ok = runCircuit(job.file, job.stats.circuitName, true, job.stats);
+            std::string msg = "Completed " + job.file + (ok ? "\n" : " (FAILED)\n");
+            std::cout << msg << std::flush;
+        });
+        auto batchEnd = sc::high_resolution_clock::now();
+        writeBatchReport("output_batch_report.csv", batch);
+        printBatchReport(batch, sc::duration_cast<sc::microseconds>(batchEnd - batchStart).count());
+        writeProfileFiles();
+        return interruptRequested() ? 130 : 0;
+    }
+
+    CircuitStats stats;
+    bool ok = runCircuit(BLIFFile, BLIFFile.substr(0, BLIFFile.length() - 5), false, stats);
+    writeProfileFiles();
+    if (interruptRequested()) return 130;
+    return ok ? 0 : -1;
 }
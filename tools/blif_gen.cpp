@@ -0,0 +1,238 @@
+//
+// blif_gen: deterministic synthetic BLIF netlists for scaling studies
+//
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+struct GenConfig {
+    long long gates = 10000;
+    int inputs = 64;
+    int outputs = 64;
+    int latches = 0;
+    int depth = 20;
+    int faninMin = 2;
+    int faninMax = 3;
+    double fanoutSkew = 0.3;     //chance an extra fan-in reuses the driver of an existing edge (heavy tailed fan-out)
+    double reconvergence = 0.2;  //chance an extra fan-in is taken from the fan-in of an already chosen fan-in
+    long long window = 0;        //extra fan-ins come from the last window signals (0 = any earlier signal)
+    uint64_t seed = 1;
+    std::string outFile = "";
+};
+
+//signals 0..sources-1 are PIs followed by latch outputs, gate g is signal sources+g
+struct Netlist {
+    long long sources;
+    std::vector<long long> levelStart;  //first gate of each level (plus one past the end)
+    std::vector<uint64_t> faninOffset;
+    std::vector<uint32_t> fanin;
+    std::vector<std::pair<uint32_t,uint32_t>> extra;  //(gate, signal) fan-ins added so that no gate is left dangling
+};
+
+static uint64_t pick(std::mt19937_64& rng, uint64_t n){
+    return rng() % n;
+}
+
+static bool chance(std::mt19937_64& rng, double p){
+    return (rng() >> 11) * (1.0 / 9007199254740992.0) < p;
+}
+
+static void generate(GenConfig& cfg, Netlist& net){
+    std::mt19937_64 rng(cfg.seed);
+    long long G = cfg.gates;
+    int D = cfg.depth;
+    long long sinks = cfg.outputs + cfg.latches;
+    net.sources = cfg.inputs + cfg.latches;
+
+    //the last level drives the outputs and latch inputs, the other gates are spread evenly over the rest
+    long long lastLevel = std::min(sinks, G - (D - 1));
+    long long inner = G - lastLevel;
+    net.levelStart.push_back(0);
+    for (int l=1; l < D; ++l){
+        net.levelStart.push_back(inner * l / (D - 1));
+    }
+    net.levelStart.push_back(G);
+
+    std::vector<uint32_t> useCount(net.sources + G, 0);
+    net.faninOffset.reserve(G + 1);
+    net.fanin.reserve(G * (cfg.faninMin + cfg.faninMax) / 2);
+    net.faninOffset.push_back(0);
+    for (int l=0; l < D; ++l){
+        //signals of the previous level
+        long long prevBegin = (l == 0) ? 0 : net.sources + net.levelStart[l-1];
+        long long prevEnd = (l == 0) ? net.sources : net.sources + net.levelStart[l];
+        long long prevSize = prevEnd - prevBegin;
+        long long nextUnused = prevBegin;
+        for (long long g = net.levelStart[l]; g < net.levelStart[l+1]; ++g){
+            uint64_t begin = net.fanin.size();
+            //first fan-in from the previous level fixes the depth; unused signals are taken first so every
+            //gate gets a fan-out whenever the level is wide enough
+            long long first = (nextUnused < prevEnd) ? nextUnused++ : prevBegin + pick(rng, prevSize);
+            net.fanin.push_back(first);
+            int fanin = cfg.faninMin + pick(rng, cfg.faninMax - cfg.faninMin + 1);
+            long long limit = (l == 0) ? net.sources : net.sources + net.levelStart[l]; //only earlier levels
+            long long earliest = (cfg.window > 0 && limit - cfg.window > 0) ? limit - cfg.window : 0;
+            for (int tries = 0; (int) (net.fanin.size() - begin) < fanin && tries < 8 * fanin; ++tries){
+                long long s;
+                long long chosen = net.fanin[begin + pick(rng, net.fanin.size() - begin)];
+                if (chance(rng, cfg.reconvergence) && chosen >= net.sources){
+                    long long cg = chosen - net.sources;
+                    uint64_t n = net.faninOffset[cg+1] - net.faninOffset[cg];
+                    s = net.fanin[net.faninOffset[cg] + pick(rng, n)];
+                }
+                else if (chance(rng, cfg.fanoutSkew) && !net.fanin.empty() && begin > 0){
+                    s = net.fanin[pick(rng, begin)];
+                }
+                else {
+                    s = earliest + pick(rng, limit - earliest);
+                }
+                if (s >= limit) continue;
+                bool duplicate = false;
+                for (uint64_t i = begin; i < net.fanin.size(); ++i){
+                    if (net.fanin[i] == s) duplicate = true;
+                }
+                if (!duplicate) net.fanin.push_back(s);
+            }
+            for (uint64_t i = begin; i < net.fanin.size(); ++i){
+                useCount[net.fanin[i]] += 1;
+            }
+            net.faninOffset.push_back(net.fanin.size());
+        }
+    }
+
+    //a signal without fan-out would not be reachable from any output; hang it on a random gate of a later level
+    for (long long s=0; s < net.sources; ++s){
+        if (useCount[s] == 0) net.extra.push_back(std::make_pair((uint32_t) pick(rng, G), (uint32_t) s));
+    }
+    for (int l=0; l < D - 1; ++l){
+        for (long long g = net.levelStart[l]; g < net.levelStart[l+1]; ++g){
+            if (useCount[net.sources + g] != 0) continue;
+            long long later = net.levelStart[l+1] + pick(rng, G - net.levelStart[l+1]);
+            net.extra.push_back(std::make_pair((uint32_t) later, (uint32_t) (net.sources + g)));
+        }
+    }
+    std::sort(net.extra.begin(), net.extra.end());
+}
+
+static std::string signalName(Netlist& net, GenConfig& cfg, long long s){
+    if (s < cfg.inputs) return "pi" + std::to_string(s);
+    if (s < net.sources) return "lo" + std::to_string(s - cfg.inputs);
+    return "n" + std::to_string(s - net.sources);
+}
+
+static void writeList(std::ostream& out, std::string keyword, std::vector<std::string>& names){
+    out << keyword;
+    for (size_t i=0; i < names.size(); ++i){
+        if (i > 0 && i % 16 == 0) out << " \\\n";
+        out << " " << names[i];
+    }
+    out << "\n";
+}
+
+static void writeBLIF(std::ostream& out, GenConfig& cfg, Netlist& net){
+    long long G = cfg.gates;
+    out << ".model synth_g" << G << "_d" << cfg.depth << "_s" << cfg.seed << "\n";
+    std::vector<std::string> names;
+    for (int i=0; i < cfg.inputs; ++i) names.push_back(signalName(net, cfg, i));
+    writeList(out, ".inputs", names);
+    //the last level is split between the outputs and the latch inputs
+    long long lastBegin = net.levelStart[cfg.depth - 1];
+    long long lastSize = G - lastBegin;
+    names.clear();
+    for (long long g = lastBegin; g < G; ++g){
+        if (g - lastBegin < lastSize - std::min<long long>(cfg.latches, lastSize) || cfg.latches == 0){
+            names.push_back(signalName(net, cfg, net.sources + g));
+        }
+    }
+    writeList(out, ".outputs", names);
+    for (int i=0; i < cfg.latches; ++i){
+        long long g = G - 1 - (i % lastSize);
+        out << ".latch " << signalName(net, cfg, net.sources + g) << " " << signalName(net, cfg, cfg.inputs + i) << " 0\n";
+    }
+
+    size_t e = 0;
+    std::string line;
+    for (long long g=0; g < G; ++g){
+        line = ".names";
+        int count = 0;
+        for (uint64_t i = net.faninOffset[g]; i < net.faninOffset[g+1]; ++i, ++count){
+            line += " " + signalName(net, cfg, net.fanin[i]);
+        }
+        for (; e < net.extra.size() && net.extra[e].first == g; ++e, ++count){
+            line += " " + signalName(net, cfg, net.extra[e].second);
+        }
+        line += " " + signalName(net, cfg, net.sources + g) + "\n";
+        line += std::string(count, '1') + " 1\n";
+        out << line;
+    }
+    out << ".end\n";
+}
+
+int main(int argc, char **argv){
+    GenConfig cfg;
+    for (int i=1; i < argc; ++i){
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--gates" && hasValue) cfg.gates = std::atoll(argv[++i]);
+        else if (arg == "--inputs" && hasValue) cfg.inputs = std::atoi(argv[++i]);
+        else if (arg == "--outputs" && hasValue) cfg.outputs = std::atoi(argv[++i]);
+        else if (arg == "--latches" && hasValue) cfg.latches = std::atoi(argv[++i]);
+        else if (arg == "--depth" && hasValue) cfg.depth = std::atoi(argv[++i]);
+        else if (arg == "--fanin_min" && hasValue) cfg.faninMin = std::atoi(argv[++i]);
+        else if (arg == "--fanin_max" && hasValue) cfg.faninMax = std::atoi(argv[++i]);
+        else if (arg == "--fanout_skew" && hasValue) cfg.fanoutSkew = std::atof(argv[++i]);
+        else if (arg == "--reconvergence" && hasValue) cfg.reconvergence = std::atof(argv[++i]);
+        else if (arg == "--window" && hasValue) cfg.window = std::atoll(argv[++i]);
+        else if (arg == "--seed" && hasValue) cfg.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "-o" && hasValue) cfg.outFile = argv[++i];
+        else {
+            std::cout << "Usage: blif_gen [options] [-o out.blif]" << std::endl;
+            std::cout << "--gates <n>\t\tNumber of .names gates (default 10000)" << std::endl;
+            std::cout << "--inputs <n>\t\tPrimary inputs (default 64)" << std::endl;
+            std::cout << "--outputs <n>\t\tPrimary outputs (default 64)" << std::endl;
+            std::cout << "--latches <n>\t\tLatches (default 0)" << std::endl;
+            std::cout << "--depth <n>\t\tLogic depth in gates, every level is non-empty (default 20)" << std::endl;
+            std::cout << "--fanin_min <n>\t\tMinimum fan-in per gate (default 2)" << std::endl;
+            std::cout << "--fanin_max <n>\t\tMaximum fan-in per gate, uniform in [min, max] (default 3)" << std::endl;
+            std::cout << "--fanout_skew <p>\tChance a fan-in reuses an already used driver, skews fan-out (default 0.3)" << std::endl;
+            std::cout << "--reconvergence <p>\tChance a fan-in is a fan-in of another fan-in of the gate (default 0.2)" << std::endl;
+            std::cout << "--window <n>\t\tOther fan-ins come from the last n signals, 0 = any (default 0)" << std::endl;
+            std::cout << "--seed <n>\t\tRandom seed; equal options and seed give identical files (default 1)" << std::endl;
+            std::cout << "-o <file>\t\tOutput file (default stdout)" << std::endl;
+            return (arg == "-h" || arg == "--help") ? 0 : -1;
+        }
+    }
+    if (cfg.depth < 1) cfg.depth = 1;
+    if (cfg.inputs < 1) cfg.inputs = 1;
+    if (cfg.outputs < 1 && cfg.latches < 1) cfg.outputs = 1;
+    if (cfg.faninMin < 1) cfg.faninMin = 1;
+    if (cfg.faninMax < cfg.faninMin) cfg.faninMax = cfg.faninMin;
+    if (cfg.gates < cfg.depth) cfg.gates = cfg.depth;
+    if (cfg.gates + cfg.inputs + cfg.latches > UINT32_MAX){
+        std::cerr << "Error: too many signals" << std::endl;
+        return -1;
+    }
+
+    Netlist net;
+    generate(cfg, net);
+    if (cfg.outFile == ""){
+        writeBLIF(std::cout, cfg, net);
+    }
+    else {
+        std::ofstream out(cfg.outFile);
+        if (!out.is_open()){
+            std::cerr << "Error: cannot write " << cfg.outFile << std::endl;
+            return -1;
+        }
+        writeBLIF(out, cfg, net);
+    }
+    std::cerr << "gates " << cfg.gates << ", fan-ins " << net.fanin.size() + net.extra.size()
+              << " (" << net.extra.size() << " added to avoid dangling gates)" << std::endl;
+    return 0;
+}
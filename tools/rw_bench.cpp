@@ -0,0 +1,268 @@
+//
+// rw_bench: times the parse, topological sort, delay matrix, labeling and clustering kernels in isolation
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "common.h"
+#include "Labeling.h"
+#include "LargeAlloc.h"
+
+namespace sc = std::chrono;
+
+static const char* DEFAULT_NETLISTS[] = {"example_lecture.blif", "example_paper.blif", "s9234.blif", "s13207.blif",
+                                         "b20_opt.blif", "b22_opt.blif", "b17_opt.blif"};
+
+struct BenchConfig {
+    int reps = 5;
+    int warmup = 1;
+    long long denseLimitMB = 2048;    //dense matrices larger than this are skipped
+    long long lawlerMaxNodes = 20000; //Lawler labeling evaluates max_delay per cone member, skip it above this
+    int maxDelaySamples = 1000;       //(src, dst) pairs per max_delay repetition
+    int labelThreads = 1;             //threads per giant cone in the labeling kernels and per delay matrix
+    int parallelConeMin = 16384;
+    std::string filter = "";          //only run kernels whose name contains this
+    std::string csvFile = "";
+};
+
+struct BenchStats {
+    std::string circuit;
+    std::string kernel;
+    int nodes;
+    int reps;
+    double minMs, medianMs, meanMs, stddevMs, maxMs;
+};
+
+static BenchStats summarize(std::string circuit, std::string kernel, int nodes, std::vector<double>& ms){
+    BenchStats st;
+    st.circuit = circuit;
+    st.kernel = kernel;
+    st.nodes = nodes;
+    st.reps = ms.size();
+    std::vector<double> sorted = ms;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for (auto t : sorted) sum += t;
+    st.meanMs = sum / sorted.size();
+    double var = 0;
+    for (auto t : sorted) var += (t - st.meanMs) * (t - st.meanMs);
+    st.stddevMs = (sorted.size() > 1) ? std::sqrt(var / (sorted.size() - 1)) : 0;
+    st.minMs = sorted.front();
+    st.maxMs = sorted.back();
+    size_t mid = sorted.size() / 2;
+    st.medianMs = (sorted.size() % 2) ? sorted[mid] : (sorted[mid-1] + sorted[mid]) / 2;
+    return st;
+}
+
+//runs setup (untimed) then kernel (timed) warmup + reps times
+static void bench(BenchConfig& cfg, std::vector<BenchStats>& results, std::string circuit, int nodes, std::string kernel,
+                  std::function<void()> setup, std::function<void()> body){
+    if (cfg.filter != "" && kernel.find(cfg.filter) == std::string::npos) return;
+    std::vector<double> ms;
+    for (int i=0; i < cfg.warmup + cfg.reps; ++i){
+        setup();
+        auto start = sc::high_resolution_clock::now();
+        body();
+        auto end = sc::high_resolution_clock::now();
+        if (i >= cfg.warmup){
+            ms.push_back(sc::duration_cast<sc::nanoseconds>(end - start).count() / 1e6);
+        }
+    }
+    BenchStats st = summarize(circuit, kernel, nodes, ms);
+    std::cout << std::left << std::setw(20) << circuit << std::setw(16) << kernel << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << st.minMs << std::setw(12) << st.medianMs << std::setw(12) << st.meanMs
+              << std::setw(12) << st.stddevMs << std::setw(12) << st.maxMs << std::endl;
+    results.push_back(st);
+}
+
+static void benchCircuit(BenchConfig& cfg, std::string file, std::vector<BenchStats>& results){
+    std::ifstream probe(file);
+    if (!probe.is_open()){
+        std::cout << file << ": not found, skipped" << std::endl;
+        return;
+    }
+    probe.close();
+    std::string circuit = file.substr(file.find_last_of('/') + 1);
+    circuit = circuit.substr(0, circuit.find(".blif"));
+    int piDelay = 0, poDelay = 1, nodeDelay = 1;
+
+    //the graph every later kernel works on
+    std::vector<Node> rawNodeList;
+    std::string error;
+    if (parseBLIF(file, piDelay, poDelay, nodeDelay, rawNodeList, error) != 0){
+        std::cout << file << ": " << error << ", skipped" << std::endl;
+        return;
+    }
+    std::vector<Node*> POs = obtainPONodes(rawNodeList);
+    int N = rawNodeList.size();
+    std::vector<Node*> master;
+
+    bench(cfg, results, circuit, N, "parse", [](){}, [&](){
+        std::vector<Node> nodes;
+        parseBLIF(file, piDelay, poDelay, nodeDelay, nodes, error);
+    });
+
+    auto resetTopo = [&](){
+        master.clear();
+        for (auto& n : rawNodeList) n.visited = false;
+    };
+    bench(cfg, results, circuit, N, "topo", resetTopo, [&](){
+        for (auto po : POs) addPredecessors(master, po);
+    });
+    resetTopo();
+    for (auto po : POs) addPredecessors(master, po);
+    uint32_t id = 0;
+    for (auto node : master) node->id = id++;
+
+    DelayData dd;
+    if ((long long) N * N * (long long) sizeof(int) <= cfg.denseLimitMB * 1024 * 1024){
+        bench(cfg, results, circuit, N, "delay_dense", [&](){ dd.release(); }, [&](){
+            computeDelayMatrix(master, N, false, dd, cfg.labelThreads);
+        });
+    }
+    else if (cfg.filter == "" || std::string("delay_dense").find(cfg.filter) != std::string::npos){
+        std::cout << std::left << std::setw(20) << circuit << std::setw(16) << "delay_dense" << "skipped (above --dense_limit_mb)" << std::endl;
+    }
+    bench(cfg, results, circuit, N, "delay_sparse", [&](){ dd.release(); }, [&](){
+        computeDelayMatrix(master, N, true, dd, cfg.labelThreads);
+    });
+    if (dd.mode != DELAY_SPARSE) computeDelayMatrix(master, N, true, dd, cfg.labelThreads);
+
+    //max_delay pairs: every node of a sample of fan-in cones against the cone's root, as the labeling loop calls it
+    std::vector<std::pair<Node*,Node*>> pairs;
+    std::vector<char> visited(N, false);
+    srand(1);
+    for (int tries=0; tries < 100 * cfg.maxDelaySamples && (int) pairs.size() < cfg.maxDelaySamples; ++tries){
+        Node* v = master[rand() % N];
+        std::vector<Node*> cone;
+        for (auto p : v->prev) collectPredecessors(cone, p, visited);
+        for (auto x : cone){
+            visited[x->id] = false;
+            if ((int) pairs.size() < cfg.maxDelaySamples) pairs.push_back(std::make_pair(x, v));
+        }
+    }
+    volatile long long sink = 0;
+    if (!pairs.empty()){
+        bench(cfg, results, circuit, N, "max_delay", [](){}, [&](){
+            for (auto& p : pairs) sink += max_delay(p.first, p.second, master);
+        });
+    }
+
+    LabelingOptions opts;
+    opts.maxClusterSize = 8;
+    opts.interClusterDelay = 3;
+    opts.useLawler = false;
+    opts.useExp = false;
+    opts.useExp2 = false;
+    opts.useGui = false;
+    opts.labelThreads = cfg.labelThreads;
+    opts.parallelConeMin = cfg.parallelConeMin;
+    LabelingResult res;
+    bench(cfg, results, circuit, N, "rw_label", [&](){ initializeLabels(master, N, opts, res); }, [&](){
+        computeLabels(master, POs, dd, opts, res);
+    });
+    if (res.clusters.empty()){
+        initializeLabels(master, N, opts, res);
+        computeLabels(master, POs, dd, opts, res);
+    }
+    DelayData unit;
+    prepareDelays(master, N, DELAY_UNIT, unit);
+    if (unit.mode == DELAY_UNIT){
+        bench(cfg, results, circuit, N, "delay_unit", [&](){ unit.release(); }, [&](){
+            prepareDelays(master, N, DELAY_UNIT, unit);
+        });
+        LabelingResult unitRes;
+        bench(cfg, results, circuit, N, "unit_label", [&](){ initializeLabels(master, N, opts, unitRes); }, [&](){
+            computeLabels(master, POs, unit, opts, unitRes);
+        });
+    }
+    bench(cfg, results, circuit, N, "cluster", [](){}, [&](){
+        computeClusters(master, POs, opts, res);
+    });
+    opts.useExp = true;
+    bench(cfg, results, circuit, N, "cluster_exp", [](){}, [&](){
+        computeClusters(master, POs, opts, res);
+    });
+    opts.useExp = false;
+
+    if (N <= cfg.lawlerMaxNodes){
+        LabelingOptions lawlerOpts = opts;
+        lawlerOpts.useLawler = true;
+        LabelingResult lawlerRes;
+        DelayData noMatrix;
+        bench(cfg, results, circuit, N, "lawler_label", [&](){ initializeLabels(master, N, lawlerOpts, lawlerRes); }, [&](){
+            computeLabels(master, POs, noMatrix, lawlerOpts, lawlerRes);
+        });
+    }
+    else if (cfg.filter == "" || std::string("lawler_label").find(cfg.filter) != std::string::npos){
+        std::cout << std::left << std::setw(20) << circuit << std::setw(16) << "lawler_label" << "skipped (above --lawler_max_nodes)" << std::endl;
+    }
+}
+
+int main(int argc, char **argv){
+    BenchConfig cfg;
+    std::vector<std::string> files;
+    for (int i=1; i < argc; ++i){
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--reps" && hasValue) cfg.reps = std::atoi(argv[++i]);
+        else if (arg == "--warmup" && hasValue) cfg.warmup = std::atoi(argv[++i]);
+        else if (arg == "--filter" && hasValue) cfg.filter = argv[++i];
+        else if (arg == "--csv" && hasValue) cfg.csvFile = argv[++i];
+        else if (arg == "--dense_limit_mb" && hasValue) cfg.denseLimitMB = std::atoll(argv[++i]);
+        else if (arg == "--lawler_max_nodes" && hasValue) cfg.lawlerMaxNodes = std::atoll(argv[++i]);
+        else if (arg == "--max_delay_samples" && hasValue) cfg.maxDelaySamples = std::atoi(argv[++i]);
+        else if (arg == "--label_threads" && hasValue) cfg.labelThreads = std::atoi(argv[++i]);
+        else if (arg == "--no_huge_pages") setHugePages(false);
+        else if (arg == "--parallel_cone_min" && hasValue) cfg.parallelConeMin = std::atoi(argv[++i]);
+        else if (arg == "-h" || arg == "--help"){
+            std::cout << "Usage: rw_bench [options] [netlist.blif ...]" << std::endl;
+            std::cout << "Kernels: parse, topo, delay_dense, delay_sparse, max_delay, rw_label, delay_unit, unit_label, cluster, cluster_exp, lawler_label" << std::endl;
+            std::cout << "Without netlists the bundled example_*, s9234, s13207 and b17/b20/b22 netlists in the working directory are used" << std::endl;
+            std::cout << "--reps <n>\t\tTimed repetitions per kernel (default 5)" << std::endl;
+            std::cout << "--warmup <n>\t\tUntimed repetitions before measuring (default 1)" << std::endl;
+            std::cout << "--filter <str>\t\tOnly run kernels whose name contains str" << std::endl;
+            std::cout << "--csv <file>\t\tAlso write the statistics to a CSV file" << std::endl;
+            std::cout << "--dense_limit_mb <n>\tSkip the dense delay matrix above n MB (default 2048)" << std::endl;
+            std::cout << "--lawler_max_nodes <n>\tSkip Lawler labeling above n nodes (default 20000)" << std::endl;
+            std::cout << "--max_delay_samples <n>\tmax_delay calls per repetition (default 1000)" << std::endl;
+            std::cout << "--label_threads <n>\tThreads per giant cone in rw_label/unit_label and per delay matrix (default 1, 0 = one per core)" << std::endl;
+            std::cout << "--no_huge_pages\t\tKeep the delay matrices in 4 KB pages" << std::endl;
+            std::cout << "--parallel_cone_min <n>\tSmallest cone split between the label threads (default 16384)" << std::endl;
+            return 0;
+        }
+        else files.push_back(arg);
+    }
+    if (cfg.reps < 1) cfg.reps = 1;
+    if (cfg.warmup < 0) cfg.warmup = 0;
+    if (files.empty()){
+        for (auto f : DEFAULT_NETLISTS) files.push_back(f);
+    }
+
+    std::cout << "reps=" << cfg.reps << " warmup=" << cfg.warmup << " (times in ms)" << std::endl;
+    std::cout << std::left << std::setw(20) << "CIRCUIT" << std::setw(16) << "KERNEL" << std::right
+              << std::setw(12) << "MIN" << std::setw(12) << "MEDIAN" << std::setw(12) << "MEAN"
+              << std::setw(12) << "STDDEV" << std::setw(12) << "MAX" << std::endl;
+    std::vector<BenchStats> results;
+    for (auto& f : files){
+        benchCircuit(cfg, f, results);
+    }
+
+    if (cfg.csvFile != ""){
+        std::ofstream csv(cfg.csvFile);
+        csv << "CIRCUIT,KERNEL,NODES,REPS,MIN (ms),MEDIAN (ms),MEAN (ms),STDDEV (ms),MAX (ms)" << std::endl;
+        for (auto& st : results){
+            csv << st.circuit << "," << st.kernel << "," << st.nodes << "," << st.reps << ","
+                << st.minMs << "," << st.medianMs << "," << st.meanMs << "," << st.stddevMs << "," << st.maxMs << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+#FILE: rw_regress.py
+#DESCRIPTION: Golden-output and performance regression harness. Re-runs the configurations stored under
+#             Experiments/ and compares labels, clusters and max IO delay with their output files, records
+#             phase times (rw --metrics) and peak RSS, and flags slowdowns against a stored baseline.
+#RUN ./tools/rw_regress.py --help for the options; "ctest" runs the quick set, "ctest -C Full" everything
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+REPO_DIR = os.path.dirname(SCRIPT_DIR)
+
+#Experiments/<name> holds the outputs of rw <args>
+CONFIGURATIONS = [
+    ("BASE", []),
+    ("NoMatrix", ["--no_matrix"]),
+    ("FullMatrix", ["--no_sparse"]),
+    ("Lawler", ["--lawler"]),
+    ("exp", ["--exp"]),
+    ("Cluster16", ["-s", "16"]),
+    ("Cluster32", ["-s", "32"]),
+    ("Cluster64", ["-s", "64"]),
+]
+CIRCUITS = ["s9234", "s13207", "b17_opt", "b20_opt", "b22_opt"]
+#the quick set skips the runs that take minutes (on-the-fly delays, dense matrices and Lawler on the b circuits)
+SLOW_RUNS = set((cfg, c) for cfg in ("NoMatrix", "FullMatrix", "Lawler") for c in ("b17_opt", "b20_opt", "b22_opt"))
+MAX_REPORTED_DIFFERENCES = 10
+
+
+def readTable(filename):
+    #NODE,PI?,PO?,NODE DELAY,NODE LABEL,CLUSTER SIZE,CLUSTER CONTENTS -> {node: (pi, po, delay, label, members)}
+    nodes = {}
+    with open(filename) as f:
+        next(f)
+        for line in f:
+            fields = line.rstrip("\n").split(",", 6)
+            if len(fields) < 7:
+                continue
+            nodes[fields[0]] = (fields[1], fields[2], fields[3], fields[4], frozenset(fields[6].split()))
+    return nodes
+
+
+def readClusters(filename):
+    #CLUSTER ROOT NODE,CLUSTER SIZE,CLUSTER CONTENTS -> {root: members}
+    clusters = {}
+    with open(filename) as f:
+        next(f)
+        for line in f:
+            fields = line.rstrip("\n").split(",", 2)
+            if len(fields) < 3:
+                continue
+            clusters[fields[0]] = frozenset(fields[2].split())
+    return clusters
+
+
+def readMaxIODelays(filename):
+    #every "MAX IO PATH DELAY..." statistic (Lawler reports a unit and a general delay model value)
+    delays = {}
+    with open(filename) as f:
+        for line in f:
+            if line.startswith("MAX IO PATH DELAY"):
+                key, _, value = line.rstrip("\n").partition(":")
+                delays[key] = value.strip()
+    return delays
+
+
+def compareTables(golden, new, differences):
+    for node in sorted(set(golden) | set(new)):
+        if node not in new:
+            differences.append("table: node %s missing" % node)
+        elif node not in golden:
+            differences.append("table: unexpected node %s" % node)
+        else:
+            g, n = golden[node], new[node]
+            for i, field in enumerate(("PI?", "PO?", "delay", "label")):
+                if g[i] != n[i]:
+                    differences.append("table: %s of %s is %s, expected %s" % (field, node, n[i], g[i]))
+            if g[4] != n[4]:
+                differences.append("table: cluster(%s) differs (%d members, expected %d)" % (node, len(n[4]), len(g[4])))
+
+
+def compareClusters(golden, new, differences):
+    if len(golden) != len(new):
+        differences.append("clusters: %d final clusters, expected %d" % (len(new), len(golden)))
+    for root in sorted(set(golden) | set(new)):
+        if root not in new:
+            differences.append("clusters: cluster of %s missing" % root)
+        elif root not in golden:
+            differences.append("clusters: unexpected cluster of %s" % root)
+        elif golden[root] != new[root]:
+            differences.append("clusters: cluster of %s differs" % root)
+
+
+def runRW(rw, args, circuit, netlists, workDir):
+    #returns (peak RSS in KB, phases in ms), both from the metrics file
+    blif = circuit + ".blif"
+    link = os.path.join(workDir, blif)
+    if not os.path.exists(link):
+        os.symlink(os.path.join(netlists, blif), link)
+    metrics = os.path.join(workDir, "metrics.json")
+    cmd = [rw] + args + ["--no_progress", "--metrics", metrics, blif]
+    with open(os.path.join(workDir, "stdout.txt"), "w") as out:
+        start = time.time()
+        status = subprocess.call(cmd, cwd=workDir, stdout=out, stderr=subprocess.STDOUT)
+        seconds = time.time() - start
+    if status != 0:
+        raise RuntimeError("%s exited with status %d" % (" ".join(cmd), status))
+    with open(metrics) as f:
+        data = json.load(f)
+    phases = {}
+    for p in data.get("phases", []):
+        phases[p["phase"]] = phases.get(p["phase"], 0) + p["ns"] / 1e6
+    phases["total"] = seconds * 1000
+    #rw samples its own VmHWM after every phase (the RSS of a forked python would hide it in wait4's maxrss)
+    peakKB = 0
+    for m in data.get("memory", []):
+        if m["name"].startswith("PEAK RSS AFTER"):
+            peakKB = max(peakKB, m["bytes"] // 1024)
+    return peakKB, phases
+
+
+def checkPerformance(key, peakKB, phases, baseline, threshold, minMs, slowdowns):
+    base = baseline.get(key)
+    if base is None:
+        return
+    for phase, ms in sorted(phases.items()):
+        old = base["phases_ms"].get(phase)
+        if old is not None and ms > old * (1 + threshold) and ms - old > minMs:
+            slowdowns.append("%s: %s took %.1f ms, baseline %.1f ms (+%.0f%%)" % (key, phase, ms, old, 100 * (ms / old - 1)))
+    oldKB = base.get("peak_rss_kb")
+    if oldKB and peakKB > oldKB * (1 + threshold) and peakKB - oldKB > 1024:
+        slowdowns.append("%s: peak RSS %d KB, baseline %d KB (+%.0f%%)" % (key, peakKB, oldKB, 100.0 * (peakKB / oldKB - 1)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Re-run the Experiments/ configurations and compare with their outputs")
+    parser.add_argument("--rw", default=os.path.join(REPO_DIR, "rw"), help="rw executable")
+    parser.add_argument("--experiments", default=os.path.join(REPO_DIR, "Experiments"), help="golden output tree")
+    parser.add_argument("--netlists", default=REPO_DIR, help="directory of the .blif files")
+    parser.add_argument("--work", default="rw_regress_work", help="scratch directory for the runs")
+    parser.add_argument("--quick", action="store_true", help="skip the runs that take minutes")
+    parser.add_argument("--config", default="", help="comma separated configurations (default: all)")
+    parser.add_argument("--circuit", default="", help="comma separated circuits (default: all)")
+    parser.add_argument("--baseline", default=os.path.join(REPO_DIR, "Experiments", "perf_baseline.json"),
+                        help="phase times and peak RSS to compare against")
+    parser.add_argument("--update_baseline", action="store_true", help="store this run's measurements as the baseline")
+    parser.add_argument("--threshold", type=float, default=0.25, help="flag phases slower than baseline * (1 + threshold)")
+    parser.add_argument("--min_ms", type=float, default=50, help="ignore slowdowns of fewer milliseconds (timer noise)")
+    parser.add_argument("--fail_on_slowdown", action="store_true", help="exit with an error on flagged slowdowns")
+    parser.add_argument("--rw_args", default="", help="extra rw arguments for every run (e.g. --rw_args=--renumber)")
+    parser.add_argument("--report", default="", help="write every measurement to this JSON file")
+    args = parser.parse_args()
+
+    rw = os.path.abspath(args.rw)
+    configs = [c for c in CONFIGURATIONS if not args.config or c[0] in args.config.split(",")]
+    circuits = [c for c in CIRCUITS if not args.circuit or c in args.circuit.split(",")]
+    baseline = {}
+    if os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+
+    runs = 0
+    failures = []
+    slowdowns = []
+    measurements = {}
+    for name, rwArgs in configs:
+        for circuit in circuits:
+            goldenDir = os.path.join(args.experiments, name)
+            goldenTable = os.path.join(goldenDir, "output_%s_table.csv" % circuit)
+            if not os.path.exists(goldenTable) or (args.quick and (name, circuit) in SLOW_RUNS):
+                continue
+            key = "%s/%s" % (name, circuit)
+            runs += 1
+            workDir = os.path.abspath(os.path.join(args.work, name))
+            os.makedirs(workDir, exist_ok=True)
+            try:
+                peakKB, phases = runRW(rw, rwArgs + args.rw_args.split(), circuit, os.path.abspath(args.netlists), workDir)
+            except (RuntimeError, OSError) as e:
+                failures.append(key)
+                print("FAIL  %-22s %s" % (key, e))
+                continue
+            differences = []
+            compareTables(readTable(goldenTable), readTable(os.path.join(workDir, "output_%s_table.csv" % circuit)), differences)
+            compareClusters(readClusters(os.path.join(goldenDir, "output_%s_cluster.csv" % circuit)),
+                            readClusters(os.path.join(workDir, "output_%s_cluster.csv" % circuit)), differences)
+            goldenVerbose = os.path.join(goldenDir, "output_%s_verbose.txt" % circuit)
+            if os.path.exists(goldenVerbose):
+                golden = readMaxIODelays(goldenVerbose)
+                new = readMaxIODelays(os.path.join(workDir, "output_%s_verbose.txt" % circuit))
+                for stat in sorted(golden):
+                    if golden[stat] != new.get(stat):
+                        differences.append("%s is %s, expected %s" % (stat, new.get(stat), golden[stat]))
+            measurements[key] = {"phases_ms": phases, "peak_rss_kb": peakKB}
+            checkPerformance(key, peakKB, phases, baseline, args.threshold, args.min_ms, slowdowns)
+            status = "ok" if not differences else "FAIL"
+            print("%-5s %-22s %8.0f ms %8d KB" % (status, key, phases["total"], peakKB))
+            sys.stdout.flush()
+            if differences:
+                failures.append(key)
+                for d in differences[:MAX_REPORTED_DIFFERENCES]:
+                    print("      " + d)
+                if len(differences) > MAX_REPORTED_DIFFERENCES:
+                    print("      ... %d more differences" % (len(differences) - MAX_REPORTED_DIFFERENCES))
+
+    for s in slowdowns:
+        print("SLOWER " + s)
+    if args.report:
+        with open(args.report, "w") as f:
+            json.dump(measurements, f, indent=2, sort_keys=True)
+    if args.update_baseline:
+        #runs not repeated this time keep their old entries
+        baseline.update(measurements)
+        with open(args.baseline, "w") as f:
+            json.dump(baseline, f, indent=2, sort_keys=True)
+            f.write("\n")
+        print("Baseline written to " + args.baseline)
+    print("%d runs, %d failed, %d slowdowns over %.0f%%" %
+          (runs, len(failures), len(slowdowns), 100 * args.threshold))
+    if failures or (slowdowns and args.fail_on_slowdown):
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
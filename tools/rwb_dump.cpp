@@ -0,0 +1,123 @@
+//
+// rwb_dump: small reader for the binary result files written by rw --binary
+//
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ResultFile.h"
+#include "GuiExport.h"
+
+static int writeGui(ResultFileReader& rf, int argc, char **argv){
+    //--gui <nodes|clusters|levels> [--fanin name,name,...] [--depth d] [--out file]
+    int granularity = -1;
+    std::string view = (argc > 3) ? argv[3] : "";
+    if (view == "nodes") granularity = GUI_VIEW_NODES;
+    else if (view == "clusters") granularity = GUI_VIEW_CLUSTERS;
+    else if (view == "levels") granularity = GUI_VIEW_LEVELS;
+    else {
+        std::cout << "Error: --gui expects nodes, clusters or levels" << std::endl;
+        return -1;
+    }
+    std::vector<std::string> seeds;
+    int depth = -1;
+    std::string outFile = "input_graph.dmp";
+    for (int i=4; i+1 < argc; i += 2){
+        std::string opt = argv[i];
+        if (opt == "--fanin"){
+            std::stringstream names(argv[i+1]);
+            std::string name;
+            while (std::getline(names, name, ',')){
+                if (!name.empty()) seeds.push_back(name);
+            }
+        }
+        else if (opt == "--depth") depth = std::stoi(argv[i+1]);
+        else if (opt == "--out") outFile = argv[i+1];
+        else {
+            std::cout << "Error: unknown option " << opt << std::endl;
+            return -1;
+        }
+    }
+
+    std::vector<uint32_t> selected;
+    std::string error;
+    if (!selectGuiVertices(rf, granularity, seeds, depth, selected, error)){
+        std::cout << "Error: " << error << std::endl;
+        return -1;
+    }
+    GuiView gv;
+    buildGuiView(rf, granularity, selected, gv);
+    if (!writeGuiView(gv, outFile)){
+        std::cout << "Error: cannot write " << outFile << std::endl;
+        return -1;
+    }
+    std::cout << "Wrote " << gv.vertices.size() << " vertices and " << gv.clusters.size() << " clusters to " << outFile << std::endl;
+    return 0;
+}
+
+int main(int argc, char **argv){
+    if (argc < 2){
+        std::cout << "Usage: rwb_dump <output_circuit_result.rwb> [--nodes|--clusters]" << std::endl;
+        std::cout << "       rwb_dump <output_circuit_result.rwb> --gui <nodes|clusters|levels> [--fanin name,name,...] [--depth d] [--out file]" << std::endl;
+        std::cout << "       (--gui writes a GUI file for RWGUI.py: the whole view, or with --fanin only the fan-in" << std::endl;
+        std::cout << "        neighbourhood, up to depth vertices back, of the nodes or of the clusters/levels holding them)" << std::endl;
+        return 0;
+    }
+    std::string mode = (argc > 2) ? argv[2] : "";
+
+    ResultFileReader rf;
+    if (!rf.open(argv[1])){
+        std::cout << "Error: " << rf.lastError() << std::endl;
+        return -1;
+    }
+    const RWBHeader& hdr = rf.header();
+
+    if (mode == "--gui"){
+        return writeGui(rf, argc, argv);
+    }
+    if (mode == "--nodes"){
+        std::cout << "NODE,PI?,PO?,NODE DELAY,NODE LABEL,CLUSTER SIZE,CLUSTER CONTENTS" << std::endl;
+        bool perNode = !(hdr.flags & RWB_FLAG_LAWLER);
+        for (uint64_t i=0; i < rf.nodeCount(); ++i){
+            const RWBNode& n = rf.node(i);
+            std::cout << rf.nodeName(i) << "," << (n.isPI ? "Y" : "N") << "," << (n.isPO ? "Y" : "N") << ","
+                      << n.delay << "," << n.label << ",";
+            if (perNode){
+                const RWBCluster& c = rf.cluster(i);
+                std::cout << c.memberCount << ",";
+                const uint32_t *mem = rf.members(c);
+                for (uint32_t m=0; m < c.memberCount; ++m){
+                    std::cout << rf.nodeName(mem[m]) << " ";
+                }
+            }
+            std::cout << std::endl;
+        }
+    }
+    else if (mode == "--clusters"){
+        std::cout << "CLUSTER ROOT NODE,CLUSTER SIZE,CLUSTER CONTENTS" << std::endl;
+        for (uint64_t i=0; i < rf.finalCount(); ++i){
+            const RWBCluster& c = rf.finalCluster(i);
+            std::cout << rf.nodeName(c.rootId) << "," << c.memberCount << ",";
+            const uint32_t *mem = rf.members(c);
+            for (uint32_t m=0; m < c.memberCount; ++m){
+                std::cout << rf.nodeName(mem[m]) << " ";
+            }
+            std::cout << std::endl;
+        }
+    }
+    else {
+        std::cout << "RESULT FILE VERSION:\t" << hdr.version << std::endl;
+        std::cout << "RUN MODE:\t" << ((hdr.flags & RWB_FLAG_LAWLER) ? "LAWLER" : "RW CLUSTERING") << std::endl;
+        std::cout << "NON-OVERLAP MODE:\t" << ((hdr.flags & RWB_FLAG_EXP) ? "ENABLED" : "DISABLED") << std::endl;
+        std::cout << "Max Cluster Size:\t" << hdr.maxClusterSize << std::endl;
+        std::cout << "Inter Cluster Delay:\t" << hdr.interClusterDelay << std::endl;
+        std::cout << "Primary Input Delay:\t" << hdr.piDelay << std::endl;
+        std::cout << "Primary Output Delay:\t" << hdr.poDelay << std::endl;
+        std::cout << "Node Delay:\t" << hdr.nodeDelay << std::endl;
+        std::cout << "TOTAL NUMBER OF NODES:\t" << hdr.nodeCount << std::endl;
+        std::cout << "NUMBER OF CLUSTERS:\t" << hdr.finalCount << std::endl;
+        std::cout << "MAX IO PATH DELAY:\t" << hdr.maxIODelay << std::endl;
+    }
+    return 0;
+}